@@ -24,7 +24,9 @@ namespace sklib
 #include "bitwise/bmanip.hpp"
 #include "bitwise/bstream.hpp"
 #include "bitwise/base64.hpp"
+#include "bitwise/radix-codec.hpp"
 #include "bitwise/bprops.hpp"
+#include "bitwise/bpacket.hpp"
 
 
 };
@@ -37,13 +39,28 @@ namespace sklib
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 // conditional include of <string> is done in types.hpp
 
 namespace sklib
 {
 #include "bitwise/bfstream.hpp"
+#include "bitwise/radix-parallel.hpp"
 };
 
+#ifdef SKLIB_TARGET_TEST
+
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+namespace sklib
+{
+#include "bitwise/radix-testing.hpp"
+};
+
+#endif // SKLIB_TARGET_TEST
+
 #endif // SKLIB_TARGET_MCU
 
 #endif // SKLIB_INCLUDED_BITWISE_HPP
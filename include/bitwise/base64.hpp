@@ -63,7 +63,8 @@ public:
     static constexpr size_t encoded_length(size_t raw_data_input_length)
     {
         size_t blocks_count = raw_data_input_length / raw_data_block_size;
-        size_t tail_length = raw_data_input_length % raw_data_block_size;     // { 0, 1, 2 } => { 0, 1, 2 }
+        size_t tail_length = raw_data_input_length % raw_data_block_size;
+        if (tail_length) tail_length++;                                     // { 0, 1, 2 } => { 0, 2, 3 }
         return blocks_count * encoded_block_size + tail_length;
     }
 
@@ -0,0 +1,199 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides compile-time packet layout (sequence of bit fields) serialized to/from bits stream
+// This is internal SKLib file and must NOT be included directly.
+
+// The packet is declared once by the list of field widths, in the order of transmission:
+//   typedef sklib::bits_packet_type<3, 12, 1, 40> telemetry_frame;
+// Field I is accessed by get<I>() and set<I>(); the fields are transmitted MSB first, same as bits_pack().
+// Instead of one stream operation per field, write() and read() combine adjacent fields into 64-bit words,
+// so the number of stream operations is bit_length/64 (rounded up) regardless of the number of fields.
+// Fields may be set from bit_props values directly; bit_props_width_v<> gives matching field width.
+
+namespace priv
+{
+    template<unsigned N>
+    using bits_packet_field_type = std::conditional_t<(N <= 8), uint8_t,
+                                   std::conditional_t<(N <= 16), uint16_t,
+                                   std::conditional_t<(N <= 32), uint32_t, uint64_t>>>;
+
+    constexpr uint64_t bits_packet_mask(unsigned width)
+    {
+        return (width >= sklib::bits_width_v<uint64_t> ? sklib::bits_mask_v<uint64_t> : (uint64_t(1) << width) - 1);
+    }
+
+    template<class T>
+    constexpr unsigned bit_props_width()
+    {
+        typedef std::remove_cv_t<decltype(T::data)> data_type;   // T::data_type may be hidden by bit_props_config_type
+        if constexpr (std::is_base_of_v<sklib::priv::bit_props_group_anchor, T>)
+        {
+            unsigned R = 0;
+            for (auto m = sklib::to_unsigned_if_integer(T::mask); m; m >>= 1) R++;
+            return R;
+        }
+        else
+        {
+            return sklib::bits_width_v<data_type>;
+        }
+    }
+};
+
+// number of bits that holds a bit_props value: up to the highest bit of the mask for bit_props groups/configs,
+// or full data type width otherwise
+template<class T>
+inline constexpr unsigned bit_props_width_v = sklib::priv::bit_props_width<T>();
+
+template<unsigned ...Widths>
+class bits_packet_type
+{
+    static_assert(sizeof...(Widths) > 0, "Bits packet must have at least one field");
+    static_assert(((Widths > 0 && Widths <= sklib::bits_width_v<uint64_t>) && ...), "Bits packet field width must be from 1 to 64");
+
+public:
+    static constexpr unsigned field_count = sizeof...(Widths);
+    static constexpr unsigned field_width[field_count] = { Widths... };
+    static constexpr unsigned bit_length = (Widths + ...);
+    static constexpr size_t octet_length = (bit_length + sklib::OCTET_BITS - 1) / sklib::OCTET_BITS;
+
+    // position of the first (most significant) bit of the field, counting from the start of the packet
+    static constexpr unsigned field_offset(unsigned index)
+    {
+        unsigned R = 0;
+        for (unsigned k=0; k<index && k<field_count; k++) R += field_width[k];
+        return R;
+    }
+
+    template<unsigned I>
+    using field_type = sklib::priv::bits_packet_field_type<field_width[I]>;
+
+    constexpr bits_packet_type() = default;
+
+    template<class ...T>
+    constexpr bits_packet_type(T... values)
+    {
+        static_assert(sizeof...(T) == field_count, "Bits packet constructor needs a value for every field");
+        unsigned k = 0;
+        ((data[k] = uint64_t(values) & sklib::priv::bits_packet_mask(field_width[k]), k++), ...);
+    }
+
+    template<unsigned I>
+    constexpr field_type<I> get() const
+    {
+        static_assert(I < field_count, "Bits packet field index is out of range");
+        return field_type<I>(data[I]);
+    }
+
+    template<unsigned I, class T>
+    constexpr SKLIB_TYPE_ENABLE_IF_INT(void, T) set(T value)
+    {
+        static_assert(I < field_count, "Bits packet field index is out of range");
+        data[I] = uint64_t(value) & sklib::priv::bits_packet_mask(field_width[I]);
+    }
+
+    template<unsigned I, class T>
+    constexpr SKLIB_TYPE_ENABLE_IF_CONDITION(void, (std::is_base_of_v<sklib::priv::bit_props_anchor, T>)) set(const T& props)
+    {
+        static_assert(bit_props_width_v<T> <= field_width[I], "Bits packet field is too narrow for this bit_props type");
+        set<I>(props.data);
+    }
+
+    // sends all fields to the stream, one stream operation per 64 bits
+    void write(sklib::bits_stream_base_type& stream) const
+    {
+        constexpr unsigned N = sklib::bits_width_v<uint64_t>;
+        uint64_t acc = 0;
+        unsigned used = 0;
+
+        for (unsigned k=0; k<field_count; k++)
+        {
+            unsigned w = field_width[k];
+            uint64_t v = data[k];
+
+            if (used + w < N)
+            {
+                acc = (acc << w) | v;
+                used += w;
+                continue;
+            }
+
+            unsigned head = N - used;    // field goes across the word boundary (or fills the word exactly)
+            acc = (head == N ? v >> (w - head) : (acc << head) | (v >> (w - head)));
+            stream.write(sklib::bits_pack<N, uint64_t>(acc));
+
+            used = w - head;
+            acc = v & sklib::priv::bits_packet_mask(used);
+        }
+
+        if (used) stream.write(sklib::bits_pack<uint64_t>(acc, used));
+    }
+
+    // receives all fields from the stream, one stream operation per 64 bits
+    void read(sklib::bits_stream_base_type& stream)
+    {
+        constexpr unsigned N = sklib::bits_width_v<uint64_t>;
+        unsigned remaining = bit_length;
+        uint64_t acc = 0;
+        unsigned avail = 0;
+
+        auto fetch = [&]()
+        {
+            auto pack = sklib::bits_pack<uint64_t>(0, sklib::priv::alt_min(remaining, N));
+            stream.read(pack);
+            remaining -= pack.bit_count;
+            avail = pack.bit_count;
+            acc = pack.data;
+        };
+
+        for (unsigned k=0; k<field_count; k++)
+        {
+            unsigned w = field_width[k];
+            if (!avail) fetch();
+
+            if (w <= avail)
+            {
+                avail -= w;
+                data[k] = (acc >> avail) & sklib::priv::bits_packet_mask(w);
+                continue;
+            }
+
+            unsigned tail = w - avail;   // field goes across the word boundary
+            uint64_t v = acc & sklib::priv::bits_packet_mask(avail);
+            fetch();
+            avail -= tail;
+            data[k] = (v << tail) | ((acc >> avail) & sklib::priv::bits_packet_mask(tail));
+        }
+    }
+
+    constexpr bool operator== (const bits_packet_type& X) const
+    {
+        for (unsigned k=0; k<field_count; k++) if (data[k] != X.data[k]) return false;
+        return true;
+    }
+    constexpr bool operator!= (const bits_packet_type& X) const { return !operator== (X); }
+
+private:
+    uint64_t data[field_count] = { 0 };
+};
+
+template<unsigned ...Widths>
+sklib::bits_stream_base_type& operator<< (sklib::bits_stream_base_type& stream, const bits_packet_type<Widths...>& packet)
+{
+    packet.write(stream);
+    return stream;
+}
+
+template<unsigned ...Widths>
+sklib::bits_stream_base_type& operator>> (sklib::bits_stream_base_type& stream, bits_packet_type<Widths...>& packet)
+{
+    packet.read(stream);
+    return stream;
+}
@@ -148,8 +148,8 @@ public:
     void read_rewind()
     {
         if (hook_action) hook_action(hook_type::before_rewind);
-        uint8_t accumulator_receiver = 0;
-        uint8_t available_bits_receiver = 0;
+        accumulator_receiver = 0;
+        available_bits_receiver = 0;
     }
 
     // true if internal storage has enough data for the next read
@@ -0,0 +1,503 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides block-oriented streaming codecs for radix 2^k text encodings: Base16, Base32, Base64, Base64url (RFC 4648)
+// This is internal SKLib file and must NOT be included directly.
+
+// Unlike base64_type, the codecs receive input in chunks of arbitrary size and put the result into
+// the caller's buffer, without per-character callbacks. Complete groups (the shortest sequence that
+// holds whole octets and whole symbols, e.g. 3 octets <=> 4 symbols for Base64) are converted by bulk
+// loops; only the incomplete group is carried over between calls, so the stream of any length is
+// processed in constant memory.
+//
+// The alphabet is described at compile time by the class with the following members:
+//   encoding_bit_length - bit count per symbol, k = 1...6
+//   dictionary[]        - 2^k symbols, zero-terminated
+//   EOL_char            - padding/terminator symbol
+//   case_insensitive    - decoder also accepts letters in the opposite case
+
+// ---------------------------------------------------------------------------
+// Standard alphabets
+
+struct base16_alphabet_type
+{
+    static constexpr int encoding_bit_length = 4;
+    static constexpr char dictionary[] = "0123456789ABCDEF";
+    static constexpr char EOL_char = '=';
+    static constexpr bool case_insensitive = true;
+};
+
+struct base32_alphabet_type
+{
+    static constexpr int encoding_bit_length = 5;
+    static constexpr char dictionary[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    static constexpr char EOL_char = '=';
+    static constexpr bool case_insensitive = true;
+};
+
+struct base64_alphabet_type
+{
+    static constexpr int encoding_bit_length = 6;
+    static constexpr char dictionary[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    static constexpr char EOL_char = '=';
+    static constexpr bool case_insensitive = false;
+};
+
+struct base64url_alphabet_type
+{
+    static constexpr int encoding_bit_length = 6;
+    static constexpr char dictionary[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    static constexpr char EOL_char = '=';
+    static constexpr bool case_insensitive = false;
+};
+
+// ---------------------------------------------------------------------------
+// Codec engine
+
+namespace priv
+{
+    template<class Alphabet>
+    constexpr sklib::aux::encapsulated_array_octet_index_type<uint8_t> radix_generate_inverse_table();
+
+    constexpr unsigned radix_group_bit_length(unsigned symbol_bits)
+    {
+        unsigned R = symbol_bits;
+        while (R % sklib::OCTET_BITS) R += symbol_bits;
+        return R;
+    }
+};
+
+template<class Alphabet>
+class radix_codec_property_type : public Alphabet
+{
+    friend constexpr sklib::aux::encapsulated_array_octet_index_type<uint8_t> sklib::priv::radix_generate_inverse_table<Alphabet>();
+
+    static_assert(Alphabet::encoding_bit_length > 0 && Alphabet::encoding_bit_length <= 6,
+                  "Radix codec alphabet must use from 1 to 6 bits per symbol");
+    static_assert(sizeof(Alphabet::dictionary) == (size_t(1) << Alphabet::encoding_bit_length) + 1,
+                  "Radix codec dictionary must contain exactly 2^encoding_bit_length symbols");
+
+public:
+    static constexpr size_t dictionary_size = (size_t(1) << Alphabet::encoding_bit_length);
+    static constexpr uint8_t dictionary_address_mask = uint8_t(dictionary_size - 1);
+
+    // group: the shortest bit sequence that consists of whole octets and whole symbols
+    static constexpr unsigned group_bit_length = sklib::priv::radix_group_bit_length(Alphabet::encoding_bit_length);
+    static constexpr size_t raw_group_size = group_bit_length / sklib::OCTET_BITS;
+    static constexpr size_t encoded_group_size = group_bit_length / Alphabet::encoding_bit_length;
+
+    typedef std::conditional_t<(group_bit_length > sklib::bits_width_v<uint32_t>), uint64_t, uint32_t> group_word_type;
+
+    // number of symbols to encode given number of octets, without padding
+    static constexpr size_t encoded_length(size_t raw_data_input_length)
+    {
+        size_t blocks_count = raw_data_input_length / raw_group_size;
+        size_t tail_bits = raw_data_input_length % raw_group_size * sklib::OCTET_BITS;
+        return blocks_count * encoded_group_size + (tail_bits + Alphabet::encoding_bit_length - 1) / Alphabet::encoding_bit_length;
+    }
+
+    // number of octets encoded by given number of symbols, without padding
+    static constexpr size_t decoded_length(size_t encoded_input_length)
+    {
+        size_t blocks_count = encoded_input_length / encoded_group_size;
+        size_t tail_bits = encoded_input_length % encoded_group_size * Alphabet::encoding_bit_length;
+        return blocks_count * raw_group_size + tail_bits / sklib::OCTET_BITS;
+    }
+
+protected:
+    // special Inverse/Decode table entries, same as in base64_property_type
+    static constexpr uint8_t EOL_code   = 0xF9;     // input was EOL/padding
+    static constexpr uint8_t Space_code = 0xF0;     // Space or Blank ASCII character
+    static constexpr uint8_t Bad_code   = 0xFF;     // invalid input
+};
+
+namespace priv
+{
+    template<class Alphabet>
+    constexpr sklib::aux::encapsulated_array_octet_index_type<uint8_t> radix_generate_inverse_table()
+    {
+        typedef sklib::radix_codec_property_type<Alphabet> prop;
+
+        sklib::aux::encapsulated_array_octet_index_type<uint8_t> R = { 0 };
+        for (int k=0; k<=' '; k++) R.data[k] = prop::Space_code;
+        for (int k=' '+1; k<sklib::OCTET_ADDRESS_SPAN; k++) R.data[k] = prop::Bad_code;
+        R.data[uint8_t(prop::EOL_char)] = prop::EOL_code;
+
+        if (prop::case_insensitive)     // alias letters go first, so they never override the dictionary
+        {
+            for (size_t k=0; k<prop::dictionary_size; k++)
+            {
+                char c = prop::dictionary[k];
+                if (c >= 'A' && c <= 'Z') R.data[uint8_t(c - 'A' + 'a')] = uint8_t(k);
+                if (c >= 'a' && c <= 'z') R.data[uint8_t(c - 'a' + 'A')] = uint8_t(k);
+            }
+        }
+
+        for (size_t k=0; k<prop::dictionary_size; k++) R.data[uint8_t(prop::dictionary[k])] = uint8_t(k);
+        return R;
+    }
+
+    template<class Alphabet>
+    inline constexpr sklib::aux::encapsulated_array_octet_index_type<uint8_t> radix_dictionary_inverse = radix_generate_inverse_table<Alphabet>();
+
+    // bulk conversion of complete groups, no whitespace, no line breaks
+    template<class Alphabet>
+    class radix_block_kernel_type : public sklib::radix_codec_property_type<Alphabet>
+    {
+    private:
+        typedef sklib::radix_codec_property_type<Alphabet> prop;
+        typedef typename prop::group_word_type word_type;
+        static constexpr unsigned K = Alphabet::encoding_bit_length;
+
+    public:
+        // encodes "count" complete groups
+        static void encode_groups(const uint8_t* input, size_t count, char* output)
+        {
+            for (size_t n=0; n<count; n++, input += prop::raw_group_size, output += prop::encoded_group_size)
+            {
+                word_type w = 0;
+                for (size_t i=0; i<prop::raw_group_size; i++) w = (w << sklib::OCTET_BITS) | input[i];
+
+                for (size_t i=prop::encoded_group_size; i--; w >>= K) output[i] = prop::dictionary[w & prop::dictionary_address_mask];
+            }
+        }
+
+        // decodes up to "count" complete groups while all symbols in a group are from the dictionary
+        // returns the number of groups actually decoded; the group that contains anything else
+        // (space, terminator, invalid character) is left for the caller to process symbol by symbol
+        static size_t decode_groups(const char* input, size_t count, uint8_t* output)
+        {
+            const uint8_t* inverse = radix_dictionary_inverse<Alphabet>.data;
+
+            size_t n = 0;
+            for (; n<count; n++, input += prop::encoded_group_size, output += prop::raw_group_size)
+            {
+                word_type w = 0;
+                unsigned special = 0;
+                for (size_t i=0; i<prop::encoded_group_size; i++)
+                {
+                    unsigned c = inverse[uint8_t(input[i])];
+                    special |= c;
+                    w = (w << K) | (c & prop::dictionary_address_mask);
+                }
+                if (special & ~unsigned(prop::dictionary_address_mask)) break;
+
+                for (size_t i=prop::raw_group_size; i--; w >>= sklib::OCTET_BITS) output[i] = uint8_t(w);
+            }
+
+            return n;
+        }
+    };
+};
+
+template<class Alphabet>
+class radix_encoder_stream_type : public sklib::radix_codec_property_type<Alphabet>
+{
+private:
+    typedef sklib::radix_codec_property_type<Alphabet> prop;
+    typedef sklib::priv::radix_block_kernel_type<Alphabet> kernel;
+
+public:
+    static constexpr unsigned mime_line_length = 76;    // RFC 2045
+    static constexpr size_t line_break_max_size = 2;    // CR LF
+
+    // maximum number of characters that finish() can produce (with line length 1, each symbol gets line break)
+    static constexpr size_t finish_capacity = prop::encoded_group_size * (1 + line_break_max_size);
+
+    // line_length - insert line break after this many symbols, 0 means no wrapping
+    // use_padding - terminate incomplete last group by padding symbols up to the group size
+    // use_crlf    - line break is CR LF (as in MIME), otherwise it is single LF
+    //
+    explicit radix_encoder_stream_type(unsigned line_length = 0, bool use_padding = true, bool use_crlf = true)
+        : line_cap(line_length)
+        , padding(use_padding)
+        , crlf(use_crlf)
+    {}
+
+    // returns to idle state, keeps options
+    void reset()
+    {
+        pending_count = 0;
+        column = 0;
+    }
+
+    // upper bound of the output size that encode() needs for input of given length, in the current state
+    size_t encode_capacity(size_t input_length) const
+    {
+        size_t symbols = (pending_count + input_length) / prop::raw_group_size * prop::encoded_group_size;
+        return symbols + (line_cap ? (symbols / line_cap + 1) * line_break_max_size : 0);
+    }
+
+    // encodes next chunk of raw data, returns number of characters written into output
+    // the caller must provide output buffer of at least encode_capacity(length) characters
+    //
+    size_t encode(const uint8_t* input, size_t length, char* output)
+    {
+        char* out = output;
+
+        if (pending_count)  // complete the group left from the previous call
+        {
+            while (pending_count < prop::raw_group_size && length)
+            {
+                pending[pending_count++] = *input++;
+                length--;
+            }
+            if (pending_count < prop::raw_group_size) return 0;
+
+            char group[prop::encoded_group_size];
+            kernel::encode_groups(pending, 1, group);
+            out = put_symbols(group, prop::encoded_group_size, out);
+            pending_count = 0;
+        }
+
+        size_t groups = length / prop::raw_group_size;
+        while (groups)
+        {
+            size_t run = groups;
+
+            if (line_cap)
+            {
+                if (column >= line_cap) out = put_line_break(out);
+
+                run = sklib::priv::alt_min(run, size_t((line_cap - column) / prop::encoded_group_size));
+                if (!run)   // line length is not a multiple of the group and the group goes across line break
+                {
+                    char group[prop::encoded_group_size];
+                    kernel::encode_groups(input, 1, group);
+                    out = put_symbols(group, prop::encoded_group_size, out);
+                    input += prop::raw_group_size;
+                    groups--;
+                    continue;
+                }
+                column += unsigned(run * prop::encoded_group_size);
+            }
+
+            kernel::encode_groups(input, run, out);
+            input += run * prop::raw_group_size;
+            out += run * prop::encoded_group_size;
+            groups -= run;
+        }
+
+        length %= prop::raw_group_size;
+        while (length--) pending[pending_count++] = *input++;
+
+        return size_t(out - output);
+    }
+
+    // encodes remaining data, adds padding if requested, and returns to idle state
+    // returns number of characters written into output, maximum is finish_capacity
+    //
+    size_t finish(char* output)
+    {
+        char* out = output;
+
+        if (pending_count)
+        {
+            uint8_t group_in[prop::raw_group_size] = { 0 };
+            for (size_t k=0; k<pending_count; k++) group_in[k] = pending[k];
+
+            char group[prop::encoded_group_size];
+            kernel::encode_groups(group_in, 1, group);
+
+            // minimum number of symbols that hold all pending bits, e.g. Base64: 1 octet => 2 symbols, 2 octets => 3 symbols
+            size_t symbols = (pending_count * sklib::OCTET_BITS + Alphabet::encoding_bit_length - 1) / Alphabet::encoding_bit_length;
+            if (padding) for (; symbols < prop::encoded_group_size; symbols++) group[symbols] = prop::EOL_char;
+
+            out = put_symbols(group, symbols, out);
+        }
+
+        reset();
+        return size_t(out - output);
+    }
+
+private:
+    const unsigned line_cap;
+    const bool padding;
+    const bool crlf;
+
+    uint8_t pending[prop::raw_group_size] = { 0 };
+    size_t pending_count = 0;
+    unsigned column = 0;
+
+    char* put_line_break(char* out)
+    {
+        if (crlf) *out++ = '\r';
+        *out++ = '\n';
+        column = 0;
+        return out;
+    }
+
+    // slow path for few symbols, observes line length
+    char* put_symbols(const char* symbols, size_t count, char* out)
+    {
+        for (size_t k=0; k<count; k++)
+        {
+            if (line_cap)
+            {
+                if (column >= line_cap) out = put_line_break(out);
+                column++;
+            }
+            *out++ = symbols[k];
+        }
+        return out;
+    }
+};
+
+template<class Alphabet>
+class radix_decoder_stream_type : public sklib::radix_codec_property_type<Alphabet>
+{
+private:
+    typedef sklib::radix_codec_property_type<Alphabet> prop;
+    typedef sklib::priv::radix_block_kernel_type<Alphabet> kernel;
+    typedef typename prop::group_word_type word_type;
+    static constexpr unsigned K = Alphabet::encoding_bit_length;
+
+public:
+    static constexpr size_t no_error = size_t(-1);
+
+    // maximum number of octets that finish() can produce
+    static constexpr size_t finish_capacity = prop::raw_group_size - 1;
+
+    radix_decoder_stream_type() = default;
+
+    // returns to idle state, clears errors
+    void reset()
+    {
+        accumulator = 0;
+        symbol_count = 0;
+        finished = false;
+        decoder_errors = false;
+        consumed = 0;
+        first_error = no_error;
+    }
+
+    // upper bound of the output size that decode() needs for input of given length, in the current state
+    size_t decode_capacity(size_t input_length) const
+    {
+        return (symbol_count + input_length) / prop::encoded_group_size * prop::raw_group_size + finish_capacity;
+    }
+
+    // decodes next chunk of text, returns number of octets written into output
+    // the caller must provide output buffer of at least decode_capacity(length) octets
+    // spaces and line breaks are skipped; invalid characters are skipped and reported as error;
+    // the first padding symbol terminates the stream, and everything after it is ignored until reset()
+    //
+    size_t decode(const char* input, size_t length, uint8_t* output)
+    {
+        const uint8_t* inverse = sklib::priv::radix_dictionary_inverse<Alphabet>.data;
+        const char* p = input;
+        const char* const end = input + length;
+        uint8_t* out = output;
+
+        while (p < end && !finished)
+        {
+            if (!symbol_count)
+            {
+                size_t groups = kernel::decode_groups(p, size_t(end - p) / prop::encoded_group_size, out);
+                p += groups * prop::encoded_group_size;
+                out += groups * prop::raw_group_size;
+                if (p == end) break;
+            }
+
+            uint8_t c = inverse[uint8_t(*p++)];
+
+            if (c < prop::dictionary_size)
+            {
+                accumulator = (accumulator << K) | c;
+                if (++symbol_count == prop::encoded_group_size)
+                {
+                    for (size_t i=prop::raw_group_size; i--; accumulator >>= sklib::OCTET_BITS) out[i] = uint8_t(accumulator);
+                    out += prop::raw_group_size;
+                    accumulator = 0;
+                    symbol_count = 0;
+                }
+            }
+            else if (c == prop::EOL_code)
+            {
+                out = flush(out, consumed + size_t(p - input) - 1);
+                finished = true;
+            }
+            else if (c == prop::Bad_code)
+            {
+                register_error(consumed + size_t(p - input) - 1);
+            }
+        }
+
+        consumed += length;
+        return size_t(out - output);
+    }
+
+    // decodes the incomplete group, if any (when the stream didn't have padding)
+    // returns number of octets written into output, maximum is finish_capacity
+    // the decoder is ready for the next stream, but errors are preserved until reset() or have_errors()
+    //
+    size_t finish(uint8_t* output)
+    {
+        uint8_t* out = flush(output, consumed);
+        finished = false;
+        consumed = 0;
+        return size_t(out - output);
+    }
+
+    // true if padding was seen and the rest of input is ignored
+    bool is_finished() const { return finished; }
+
+    // returns TRUE if any decoding error was seen since last call, clears the flag
+    bool have_errors()
+    {
+        bool R = decoder_errors;
+        decoder_errors = false;
+        return R;
+    }
+
+    // position of the first invalid character in the stream since reset(), counting all input characters
+    size_t first_error_position() const { return first_error; }
+
+private:
+    word_type accumulator = 0;
+    size_t symbol_count = 0;
+    bool finished = false;
+    bool decoder_errors = false;
+    size_t consumed = 0;
+    size_t first_error = no_error;
+
+    void register_error(size_t position)
+    {
+        decoder_errors = true;
+        if (first_error == no_error) first_error = position;
+    }
+
+    // writes out the incomplete group, e.g. Base64: 2 symbols => 1 octet, 3 symbols => 2 octets
+    // symbol count that cannot be produced by the encoder (e.g. single Base64 symbol) is an error at given position
+    uint8_t* flush(uint8_t* out, size_t position)
+    {
+        size_t octets = symbol_count * K / sklib::OCTET_BITS;
+        if (symbol_count != (octets * sklib::OCTET_BITS + K - 1) / K) register_error(position);
+
+        word_type w = accumulator << (K * (prop::encoded_group_size - symbol_count));
+        for (size_t i=0; i<octets; i++) *out++ = uint8_t(w >> (prop::group_bit_length - sklib::OCTET_BITS * (i+1)));
+
+        accumulator = 0;
+        symbol_count = 0;
+        return out;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Codecs for standard alphabets
+
+typedef radix_encoder_stream_type<base16_alphabet_type>    base16_encoder_stream_type;
+typedef radix_decoder_stream_type<base16_alphabet_type>    base16_decoder_stream_type;
+typedef radix_encoder_stream_type<base32_alphabet_type>    base32_encoder_stream_type;
+typedef radix_decoder_stream_type<base32_alphabet_type>    base32_decoder_stream_type;
+typedef radix_encoder_stream_type<base64_alphabet_type>    base64_encoder_stream_type;
+typedef radix_decoder_stream_type<base64_alphabet_type>    base64_decoder_stream_type;
+typedef radix_encoder_stream_type<base64url_alphabet_type> base64url_encoder_stream_type;
+typedef radix_decoder_stream_type<base64url_alphabet_type> base64url_decoder_stream_type;
@@ -0,0 +1,165 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides multi-threaded encoding and decoding of large payloads for radix 2^k codecs (see radix-codec.hpp)
+// This is internal SKLib file and must NOT be included directly.
+
+// The data is split into ranges at group boundaries (e.g. 3 octets <=> 4 symbols for Base64), and every
+// range is converted by its own thread directly into the preallocated output. The encoded text has no
+// padding, line breaks, or spaces, so its length is known in advance: encoded_length() / decoded_length().
+// The decoder is strict: only the trailing padding that completes the last group is accepted, anything else
+// outside the dictionary is error.
+
+struct radix_parallel_status_type
+{
+    static constexpr size_t no_error = size_t(-1);
+
+    size_t length = 0;                  // number of octets written into output
+    size_t error_position = no_error;   // position of the first invalid character in input
+
+    bool is_good() const { return (error_position == no_error); }
+};
+
+namespace priv
+{
+    // don't split payload into ranges shorter than this number of groups
+    inline constexpr size_t radix_parallel_min_groups = 16384;
+
+    template<class Alphabet>
+    size_t radix_first_invalid_symbol(const char* input, size_t length)
+    {
+        const uint8_t* inverse = radix_dictionary_inverse<Alphabet>.data;
+        for (size_t k=0; k<length; k++)
+        {
+            if (inverse[uint8_t(input[k])] >= sklib::radix_codec_property_type<Alphabet>::dictionary_size) return k;
+        }
+        return length;
+    }
+};
+
+// Encodes "length" octets into output, which must hold at least encoded_length(length) characters.
+// Returns number of characters written (same as encoded_length), no padding is added.
+// threads=0 means all available CPU cores; small payloads are encoded in the calling thread.
+//
+template<class Alphabet>
+size_t radix_encode_parallel(const uint8_t* input, size_t length, char* output, unsigned threads = 0)
+{
+    typedef sklib::radix_codec_property_type<Alphabet> prop;
+    typedef sklib::priv::radix_block_kernel_type<Alphabet> kernel;
+
+    size_t groups = length / prop::raw_group_size;
+
+    sklib::aux::parallel_split_type split(groups, 1, sklib::priv::radix_parallel_min_groups, threads);
+    split.run([=](unsigned, size_t begin, size_t end)
+    {
+        kernel::encode_groups(input + begin * prop::raw_group_size, end - begin, output + begin * prop::encoded_group_size);
+    });
+
+    size_t tail = length % prop::raw_group_size;
+    if (tail)
+    {
+        uint8_t group_in[prop::raw_group_size] = { 0 };
+        for (size_t k=0; k<tail; k++) group_in[k] = input[groups * prop::raw_group_size + k];
+
+        char group[prop::encoded_group_size];
+        kernel::encode_groups(group_in, 1, group);
+
+        char* out = output + groups * prop::encoded_group_size;
+        for (size_t k=0; k<prop::encoded_length(tail); k++) out[k] = group[k];
+    }
+
+    return prop::encoded_length(length);
+}
+
+// Decodes "length" characters into output, which must hold at least decoded_length(length) octets.
+// Trailing padding is either absent, or has exactly as many padding symbols as needed to complete the last
+// group (e.g. "QQ==" or "QUI=" for Base64); other padding is error at the first excess padding symbol, or past
+// the end of input if the padding is too short, and then output has all the data. Any other character outside
+// the dictionary (including spaces and line breaks) is error. Returns the number of octets written, and the position
+// of the first invalid character. On error, output contains all complete groups before the error. The result doesn't
+// depend on the number of threads. Symbol count that cannot be produced by the encoder (e.g. single symbol in the last
+// Base64 group) is error at the position past the last symbol (where padding starts).
+// threads=0 means all available CPU cores; small payloads are decoded in the calling thread.
+//
+template<class Alphabet>
+radix_parallel_status_type radix_decode_parallel(const char* input, size_t length, uint8_t* output, unsigned threads = 0)
+{
+    typedef sklib::radix_codec_property_type<Alphabet> prop;
+    typedef sklib::priv::radix_block_kernel_type<Alphabet> kernel;
+    typedef typename prop::group_word_type word_type;
+    constexpr unsigned K = Alphabet::encoding_bit_length;
+
+    radix_parallel_status_type R;
+
+    const size_t full_length = length;
+    while (length && input[length-1] == prop::EOL_char) length--;
+    size_t groups = length / prop::encoded_group_size;
+
+    sklib::aux::parallel_split_type split(groups, 1, sklib::priv::radix_parallel_min_groups, threads);
+    std::vector<size_t> errors(split.size(), radix_parallel_status_type::no_error);
+
+    split.run([=, &errors](unsigned part, size_t begin, size_t end)
+    {
+        const char* in = input + begin * prop::encoded_group_size;
+        size_t done = kernel::decode_groups(in, end - begin, output + begin * prop::raw_group_size);
+        if (done < end - begin)
+        {
+            in += done * prop::encoded_group_size;
+            errors[part] = (begin + done) * prop::encoded_group_size
+                         + sklib::priv::radix_first_invalid_symbol<Alphabet>(in, prop::encoded_group_size);
+        }
+    });
+
+    for (auto e : errors)
+    {
+        if (e != radix_parallel_status_type::no_error)
+        {
+            R.error_position = e;
+            R.length = e / prop::encoded_group_size * prop::raw_group_size;
+            return R;
+        }
+    }
+
+    const char* in = input + groups * prop::encoded_group_size;
+    size_t tail = length % prop::encoded_group_size;
+
+    size_t bad = sklib::priv::radix_first_invalid_symbol<Alphabet>(in, tail);
+    if (bad < tail || tail != prop::encoded_length(prop::decoded_length(tail)))
+    {
+        R.error_position = groups * prop::encoded_group_size + (bad < tail ? bad : tail);
+        R.length = groups * prop::raw_group_size;
+        return R;
+    }
+
+    word_type w = 0;
+    for (size_t k=0; k<tail; k++) w = (w << K) | sklib::priv::radix_dictionary_inverse<Alphabet>.data[uint8_t(in[k])];
+    w <<= K * (prop::encoded_group_size - tail);
+
+    uint8_t* out = output + groups * prop::raw_group_size;
+    for (size_t k=0; k<prop::decoded_length(tail); k++) out[k] = uint8_t(w >> (prop::group_bit_length - sklib::OCTET_BITS * (k+1)));
+
+    R.length = prop::decoded_length(length);
+
+    size_t padding = full_length - length;
+    size_t expected = (tail ? prop::encoded_group_size - tail : 0);
+    if (padding && padding != expected) R.error_position = (padding > expected ? length + expected : full_length);
+
+    return R;
+}
+
+inline size_t base64_encode_parallel(const uint8_t* input, size_t length, char* output, unsigned threads = 0)
+{
+    return radix_encode_parallel<base64_alphabet_type>(input, length, output, threads);
+}
+
+inline radix_parallel_status_type base64_decode_parallel(const char* input, size_t length, uint8_t* output, unsigned threads = 0)
+{
+    return radix_decode_parallel<base64_alphabet_type>(input, length, output, threads);
+}
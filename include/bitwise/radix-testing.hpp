@@ -0,0 +1,315 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides randomized equivalence test and throughput benchmark for all Base64 implementations:
+// callback-based base64_type (push and pull modes), streaming codec, and bulk codec (one or many threads)
+// This is internal SKLib file and must NOT be included directly.
+
+namespace priv
+{
+    // base64_type I/O redirected to memory buffers
+    struct base64_test_io_type
+    {
+        const char* input = nullptr;
+        size_t input_length = 0;
+        size_t input_pos = 0;
+        std::string output;
+
+        void set_input(const void* data, size_t length)
+        {
+            input = static_cast<const char*>(data);
+            input_length = length;
+            input_pos = 0;
+            output.clear();
+        }
+
+        static bool read_proc(void* self, int& data)    // raw octet or symbol, then EOF
+        {
+            auto io = static_cast<base64_test_io_type*>(self);
+            data = (io->input_pos < io->input_length ? uint8_t(io->input[io->input_pos++]) : EOF);
+            return true;
+        }
+
+        static void write_symbol_proc(void* self, int data)     // encoder output, "=" terminator is not stored
+        {
+            auto io = static_cast<base64_test_io_type*>(self);
+            if (data >= 0 && data != base64_type::EOL_char) io->output.push_back(char(data));
+        }
+
+        static void write_octet_proc(void* self, int data)      // decoder output, EOF is not stored
+        {
+            auto io = static_cast<base64_test_io_type*>(self);
+            if (data >= 0) io->output.push_back(char(data));
+        }
+    };
+
+    // callback encoder, push mode; the result has no terminator
+    inline std::string base64_test_callback_encode(base64_test_io_type& io, const std::vector<uint8_t>& raw)
+    {
+        base64_type codec(&io, base64_test_io_type::read_proc, base64_test_io_type::write_symbol_proc);
+        io.set_input(nullptr, 0);
+        for (auto c : raw) codec.write_encode(c);
+        codec.write_encode(EOF);
+        return io.output;
+    }
+
+    // callback encoder, pull mode
+    inline std::string base64_test_callback_encode_pull(base64_test_io_type& io, const std::vector<uint8_t>& raw)
+    {
+        base64_type codec(&io, base64_test_io_type::read_proc, base64_test_io_type::write_symbol_proc);
+        io.set_input(raw.data(), raw.size());
+
+        std::string R;
+        for (int c=0; c!=base64_type::EOL_char; )
+        {
+            if (codec.read_encode(c) && c != base64_type::EOL_char) R.push_back(char(c));
+        }
+        return R;
+    }
+
+    // callback decoder, push mode
+    inline std::string base64_test_callback_decode(base64_test_io_type& io, const std::string& text)
+    {
+        base64_type codec(&io, base64_test_io_type::read_proc, base64_test_io_type::write_octet_proc);
+        io.set_input(nullptr, 0);
+        for (auto c : text) codec.write_decode(uint8_t(c));
+        codec.write_decode(EOF);
+        return io.output;
+    }
+
+    // callback decoder, pull mode
+    inline std::string base64_test_callback_decode_pull(base64_test_io_type& io, const std::string& text)
+    {
+        base64_type codec(&io, base64_test_io_type::read_proc, base64_test_io_type::write_octet_proc);
+        io.set_input(text.data(), text.size());
+
+        std::string R;
+        for (int c=0; c!=EOF; )
+        {
+            if (codec.read_decode(c) && c != EOF) R.push_back(char(c));
+        }
+        return R;
+    }
+
+    // streaming encoder; chunk sizes are random up to max_chunk, or whole input if max_chunk is 0
+    inline std::string base64_test_stream_encode(const std::vector<uint8_t>& raw, std::mt19937& rnd, size_t max_chunk,
+                                                 unsigned line_length = 0, bool padding = false)
+    {
+        base64_encoder_stream_type codec(line_length, padding);
+        std::string R;
+        std::vector<char> buffer;
+
+        for (size_t pos=0; pos<raw.size(); )
+        {
+            size_t chunk = sklib::priv::alt_min(raw.size() - pos, (max_chunk ? rnd() % (max_chunk + 1) : raw.size()));
+            buffer.resize(codec.encode_capacity(chunk));
+            R.append(buffer.data(), codec.encode(raw.data() + pos, chunk, buffer.data()));
+            pos += chunk;
+        }
+
+        char tail[base64_encoder_stream_type::finish_capacity];
+        R.append(tail, codec.finish(tail));
+        return R;
+    }
+
+    // streaming decoder, same chunking rules as above
+    inline std::string base64_test_stream_decode(const std::string& text, std::mt19937& rnd, size_t max_chunk, bool* errors = nullptr)
+    {
+        base64_decoder_stream_type codec;
+        std::string R;
+        std::vector<uint8_t> buffer;
+
+        for (size_t pos=0; pos<text.size(); )
+        {
+            size_t chunk = sklib::priv::alt_min(text.size() - pos, (max_chunk ? rnd() % (max_chunk + 1) : text.size()));
+            buffer.resize(codec.decode_capacity(chunk));
+            R.append(reinterpret_cast<const char*>(buffer.data()), codec.decode(text.data() + pos, chunk, buffer.data()));
+            pos += chunk;
+        }
+
+        uint8_t tail[base64_decoder_stream_type::finish_capacity + 1];
+        R.append(reinterpret_cast<const char*>(tail), codec.finish(tail));
+        if (errors) *errors = codec.have_errors();
+        return R;
+    }
+
+    inline std::string base64_test_bulk_encode(const std::vector<uint8_t>& raw, unsigned threads)
+    {
+        std::string R(base64_type::encoded_length(raw.size()), '\0');
+        R.resize(base64_encode_parallel(raw.data(), raw.size(), R.data(), threads));
+        return R;
+    }
+
+    inline std::string base64_test_bulk_decode(const std::string& text, unsigned threads, bool* errors = nullptr)
+    {
+        std::string R(base64_type::decoded_length(text.size()), '\0');
+        auto status = base64_decode_parallel(text.data(), text.size(), reinterpret_cast<uint8_t*>(R.data()), threads);
+        R.resize(status.length);
+        if (errors) *errors = !status.is_good();
+        return R;
+    }
+
+    // inserts spaces and line breaks at random places, on average one per "period" symbols, or none if period is 0
+    inline std::string base64_test_add_whitespace(const std::string& text, std::mt19937& rnd, unsigned period)
+    {
+        if (!period) return text;
+
+        static constexpr char blanks[] = " \t\r\n";
+        std::string R;
+        for (auto c : text)
+        {
+            R.push_back(c);
+            if (rnd() % period == 0) R.push_back(blanks[rnd() % (sizeof(blanks) - 1)]);
+        }
+        return R;
+    }
+
+    // wraps text into lines of given length with CR LF, as MIME encoder would do
+    inline std::string base64_test_wrap_lines(const std::string& text, unsigned line_length)
+    {
+        std::string R;
+        for (size_t pos=0; pos<text.size(); pos += line_length)
+        {
+            if (pos) R.append("\r\n");
+            R.append(text, pos, line_length);
+        }
+        return R;
+    }
+};
+
+namespace aux
+{
+    // Randomized differential test: encodes random payloads with every available Base64 implementation and
+    // verifies that all of them produce the same text, byte for byte; then decodes the text (also with random
+    // whitespace, random chunking, line wrapping, and padding) by every decoder and compares with the payload.
+    // Returns true if all implementations agree. If verbose, prints the first mismatch found.
+    //
+    inline bool base64_equivalence_test(unsigned iterations = 1000, unsigned seed = 1, size_t max_length = 4096,
+                                        unsigned threads = 0, bool verbose = true)
+    {
+        std::mt19937 rnd(seed);
+        sklib::priv::base64_test_io_type io;
+        std::vector<uint8_t> raw;
+
+        auto report = [&](unsigned iteration, const char* what)
+        {
+            if (verbose) std::cout << "Base64 mismatch: " << what << ", iteration " << iteration
+                                   << ", payload length " << raw.size() << ", seed " << seed << "\n";
+            return false;
+        };
+
+        for (unsigned it=0; it<iterations; it++)
+        {
+            // lengths near group boundaries are the most interesting, so half of the tests are short
+            size_t length = (it % 2 ? rnd() % (max_length + 1) : rnd() % 16);
+            raw.resize(length);
+            for (auto& c : raw) c = uint8_t(rnd());
+
+            std::string reference = sklib::priv::base64_test_bulk_encode(raw, 1);
+            std::string payload(raw.begin(), raw.end());
+            size_t max_chunk = 1 + rnd() % 100;
+
+            if (reference.size() != base64_type::encoded_length(length)) return report(it, "encoded_length()");
+            if (sklib::priv::base64_test_bulk_encode(raw, threads) != reference) return report(it, "encode: bulk, many threads");
+            if (sklib::priv::base64_test_callback_encode(io, raw) != reference) return report(it, "encode: callback, push");
+            if (sklib::priv::base64_test_callback_encode_pull(io, raw) != reference) return report(it, "encode: callback, pull");
+            if (sklib::priv::base64_test_stream_encode(raw, rnd, max_chunk) != reference) return report(it, "encode: stream");
+
+            unsigned line_length = 4 + rnd() % 80;
+            std::string padded = reference + std::string((4 - reference.size() % 4) % 4, base64_type::EOL_char);
+            if (sklib::priv::base64_test_stream_encode(raw, rnd, max_chunk, line_length, true) != sklib::priv::base64_test_wrap_lines(padded, line_length))
+                return report(it, "encode: stream, wrapped and padded");
+
+            static constexpr unsigned whitespace_period[] = { 0, 77, 8, 1 };
+            for (auto period : whitespace_period)
+            {
+                std::string text = sklib::priv::base64_test_add_whitespace((rnd() % 2 ? padded : reference), rnd, period);
+                bool errors = false;
+
+                if (sklib::priv::base64_test_callback_decode(io, text) != payload) return report(it, "decode: callback, push");
+                if (sklib::priv::base64_test_callback_decode_pull(io, text) != payload) return report(it, "decode: callback, pull");
+                if (sklib::priv::base64_test_stream_decode(text, rnd, max_chunk, &errors) != payload || errors) return report(it, "decode: stream");
+                if (!period)
+                {
+                    if (sklib::priv::base64_test_bulk_decode(text, 1, &errors) != payload || errors) return report(it, "decode: bulk, one thread");
+                    if (sklib::priv::base64_test_bulk_decode(text, threads, &errors) != payload || errors) return report(it, "decode: bulk, many threads");
+                }
+            }
+        }
+
+        if (verbose) std::cout << "Base64 equivalence test passed: " << iterations << " iterations, seed " << seed << "\n";
+        return true;
+    }
+
+    // Measures encode/decode throughput (MB/s of raw data) of every Base64 implementation, for payload sizes
+    // from 1 KB up to max_length, and for decoder input with different density of whitespace. Prints the table.
+    // Each measurement repeats the operation for at least min_seconds.
+    //
+    inline void base64_benchmark(size_t max_length = size_t(16) << 20, unsigned threads = 0, double min_seconds = 0.2)
+    {
+        typedef std::chrono::steady_clock clock;
+        std::mt19937 rnd(1);
+        sklib::priv::base64_test_io_type io;
+        if (!threads) threads = sklib::aux::parallel_default_threads();
+
+        auto measure = [&](size_t bytes, auto&& task)
+        {
+            size_t rounds = 0;
+            double elapsed = 0;
+            auto start = clock::now();
+            do
+            {
+                task();
+                rounds++;
+                elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            }
+            while (elapsed < min_seconds);
+            return double(bytes) * double(rounds) / elapsed / 1e6;
+        };
+
+        auto print = [](const std::string& title, size_t length, double mbps)
+        {
+            std::cout << std::left << std::setw(40) << title << std::right << std::setw(12) << length
+                      << std::setw(12) << std::fixed << std::setprecision(1) << mbps << " MB/s\n";
+        };
+
+        std::cout << std::left << std::setw(40) << "Base64 implementation" << std::right << std::setw(12) << "bytes"
+                  << std::setw(17) << "throughput" << "\n";
+
+        for (size_t length = 1024; length <= max_length; length *= 32)
+        {
+            std::vector<uint8_t> raw(length);
+            for (auto& c : raw) c = uint8_t(rnd());
+            std::string text = sklib::priv::base64_test_bulk_encode(raw, 1);
+
+            print("encode: callback", length, measure(length, [&]() { sklib::priv::base64_test_callback_encode(io, raw); }));
+            print("encode: stream", length, measure(length, [&]() { sklib::priv::base64_test_stream_encode(raw, rnd, 0); }));
+            print("encode: stream, MIME lines", length, measure(length, [&]() { sklib::priv::base64_test_stream_encode(raw, rnd, 0, 76, true); }));
+            print("encode: bulk, 1 thread", length, measure(length, [&]() { sklib::priv::base64_test_bulk_encode(raw, 1); }));
+            print("encode: bulk, " + std::to_string(threads) + " threads", length, measure(length, [&]() { sklib::priv::base64_test_bulk_encode(raw, threads); }));
+
+            static constexpr unsigned whitespace_period[] = { 0, 77, 8 };
+            for (auto period : whitespace_period)
+            {
+                std::string noisy = sklib::priv::base64_test_add_whitespace(text, rnd, period);
+                std::string density = (period ? ", space per " + std::to_string(period) : ", no spaces");
+
+                print("decode: callback" + density, length, measure(length, [&]() { sklib::priv::base64_test_callback_decode(io, noisy); }));
+                print("decode: stream" + density, length, measure(length, [&]() { sklib::priv::base64_test_stream_decode(noisy, rnd, 0); }));
+                if (!period)
+                {
+                    print("decode: bulk, 1 thread" + density, length, measure(length, [&]() { sklib::priv::base64_test_bulk_decode(noisy, 1); }));
+                    print("decode: bulk, " + std::to_string(threads) + " threads" + density, length,
+                          measure(length, [&]() { sklib::priv::base64_test_bulk_decode(noisy, threads); }));
+                }
+            }
+        }
+    }
+};
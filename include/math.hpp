@@ -18,6 +18,7 @@
 //sk ... #include <immintrin.h>
 #include <array>
 #include <functional>
+#include <bit>
 
 #include "types.hpp"
 #include "utility.hpp"
@@ -27,6 +28,11 @@
 #include "bitwise.hpp"
 #include "checksum.hpp"
 #include "timer.hpp"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 
 // for debug!
@@ -43,5 +49,17 @@ namespace sklib
 
 };
 
+#ifdef SKLIB_TARGET_TEST
+
+#include <chrono>
+#include <iomanip>
+
+namespace sklib
+{
+#include "math/algebra/modp-testing.hpp"
+};
+
+#endif // SKLIB_TARGET_TEST
+
 #endif // SKLIB_INCLUDED_MATH_HPP
 
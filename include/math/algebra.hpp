@@ -25,9 +25,13 @@
 // Fields
 // Operators defined: addition, subtraction, multiplication, and division
 
+#include "algebra/modpow.hpp"               // modular exponentiation in Montgomery or Barrett context
+#include "algebra/barrett.hpp"              // Barrett reduction modulo any number, multiplication without division
 #include "algebra/field-modular.hpp"        // modulo prime
+#include "algebra/montgomery.hpp"           // Montgomery form modulo odd number, multiplication without division
 
 // Misc
 
-#include "algebra/pow.hpp"                  // exponentiation to integer power; positive only in ring; any in field
+#include "algebra/pow.hpp"                  // exponentiation to integer power; positive only in ring; any in field; integer root
+#include "algebra/ntt.hpp"                  // number-theoretic transform, multiplication of polynomials modulo prime
 
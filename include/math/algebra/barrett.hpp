@@ -0,0 +1,124 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides Barrett modular reduction. Reference: https://en.wikipedia.org/wiki/Barrett_reduction
+// This is internal SKLib file and must NOT be included directly.
+
+// For modulus N > 1 and W = bit width of T, the context keeps m = floor((2^(2W)-1)/N). Number x < N*2^W (product of
+// two numbers modulo N, or of a number modulo N and any number) is reduced by quotent estimate q = floor(x*m/2^(2W)),
+// that is short by at most 1, so x mod N = x - q*N, with one conditional subtraction. The reduction takes two
+// multiplications and no division; unlike Montgomery form, numbers are kept as they are, any modulus is allowed,
+// and the context is cheap to make, so it fits the tasks where the modulus changes often.
+// NB: It pays off for 64-bit modulus, where plain modp divides 128-bit number. For 32-bit modulus, the division
+// of 64-bit number is cheap on many CPUs, so the gain depends on the CPU; measure with aux::modp_benchmark().
+
+// Context: all numbers passed to mul(), add(), sub(), pow() must be below modulus, reduce() takes any number
+// with the high part below modulus.
+//
+SKLIB_TEMPLATE_IF_UINT(T)
+class barrett_context_type
+{
+    static_assert(sklib::bits_width_v<T> <= sklib::bits_width_v<uint64_t>, "Barrett context is defined for up to 64-bit integers");
+
+public:
+    typedef T data_type;
+
+    barrett_context_type() = default;
+
+    explicit barrett_context_type(T modulus)
+        : N(modulus)
+    {
+        if (!is_valid()) return;
+
+        if constexpr (wide)
+        {
+            uint64_t R = 0;
+            sklib::priv::udiv128_64(~uint64_t(0), ~uint64_t(0), N, M1, M0, R);
+        }
+        else
+        {
+            M0 = (~uint64_t(0) >> (sklib::bits_width_v<uint64_t> - 2*sklib::bits_width_v<T>)) / N;
+        }
+    }
+
+    bool is_valid() const { return (N > 1); }
+    T modulus() const { return N; }
+
+    // (hi:lo) mod N, requires hi < N
+    T reduce(T hi, T lo) const
+    {
+        if constexpr (wide)
+        {
+            // q = floor((hi:lo) * (M1:M0) / 2^128), the product of low words only contributes carry
+            uint64_t h00, l00, h01, l01, h10, l10;
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(lo, M0, &h00, &l00);
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(lo, M1, &h01, &l01);
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(hi, M0, &h10, &l10);
+
+            uint64_t mid = h00 + l01;
+            uint64_t carry = (mid < h00);
+            mid += l10;
+            carry += (mid < l10);
+            uint64_t q = hi * M1 + h01 + h10 + carry;
+
+            uint64_t ph, pl;
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(q, N, &ph, &pl);
+            uint64_t rl = lo - pl;
+            uint64_t rh = hi - ph - (lo < pl);
+            return ((rh || rl >= N) ? rl - N : rl);
+        }
+        else
+        {
+            uint64_t x = (uint64_t(hi) << sklib::bits_width_v<T>) | lo;
+            uint64_t q = 0;
+            if constexpr (2*sklib::bits_width_v<T> == sklib::bits_width_v<uint64_t>)
+            {
+                uint64_t pl;
+                sklib::priv::platform_AMD_x64::cpu_umul128_64(x, M0, &q, &pl);
+            }
+            else
+            {
+                q = (x * M0) >> (2*sklib::bits_width_v<T>);
+            }
+
+            uint64_t r = x - q * N;
+            return T(r >= N ? r - N : r);
+        }
+    }
+
+    T mul(T A, T B) const
+    {
+        if constexpr (wide)
+        {
+            uint64_t hi, lo;
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(A, B, &hi, &lo);
+            return reduce(hi, lo);
+        }
+        else
+        {
+            uint64_t P = uint64_t(A) * B;
+            return reduce(T(P >> sklib::bits_width_v<T>), T(P));
+        }
+    }
+
+    T add(T A, T B) const { return (A >= N - B ? A - (N - B) : A + B); }
+    T sub(T A, T B) const { return (A >= B ? A - B : A + (N - B)); }
+
+    T one() const { return T(1); }              // same as in Montgomery context, for modpow()
+
+    T pow(T A, uint64_t e) const { return sklib::modpow(*this, A, e); }
+
+private:
+    static constexpr bool wide = (sklib::bits_width_v<T> > sklib::bits_width_v<uint32_t>);
+
+    T N = 0;
+    uint64_t M1 = 0;    // m = floor((2^(2W)-1)/N), high word, only for 64-bit T
+    uint64_t M0 = 0;    // low word
+};
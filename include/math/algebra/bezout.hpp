@@ -19,9 +19,10 @@
 //   - subtraction: operator-=
 // 
 // Divides A >= 0 by B > 0 and returns quotent in the name, remainder in R
+// For native integers, see the binary versions below.
 
 template<class T>
-T bezout(T A, T B, T& ka, T& kb)
+SKLIB_TYPE_ENABLE_IF_CONDITION(T, !sklib::is_native_integer_v<T>) bezout(T A, T B, T& ka, T& kb)
 {
     ka=1;
     kb=0;
@@ -58,3 +59,184 @@ T bezout(T A, T B, T& ka, T& kb)
     return A;
 }
 
+// Versions for native integers: GCD by binary (Stein's) algorithm, which uses only shifts and subtractions;
+// Bezout coefficients either by the Euclid's algorithm in native arithmetic, or by extended binary algorithm.
+// Reference: https://en.wikipedia.org/wiki/Binary_GCD_algorithm
+// The extended binary algorithm keeps the coefficient of the odd number modulo the other number, dividing it by
+// powers of 2 exactly (same as Montgomery reduction), and it finds the other coefficient by single division in the end.
+// It needs no division in the loop, but it does more work per step: it is only faster where division is slow,
+// for example, on microcontrollers; with hardware division, bezout() is faster.
+// For unsigned T, negative coefficient is returned complemented, so A*ka + B*kb = D holds modulo 2^width,
+// same as from the generic version. In all versions, GCD is nonnegative.
+
+namespace priv
+{
+    // absolute value of native integer, as unsigned
+    template<class T>
+    constexpr std::make_unsigned_t<T> bezout_native_abs(T A)
+    {
+        typedef std::make_unsigned_t<T> U;
+        if constexpr (std::is_signed_v<T>) if (A < 0) return U(-U(A));
+        return U(A);
+    }
+
+    // a / 2^z modulo odd y, for a < y, 0 < z < width; yinv = 1/y modulo 2^width
+    template<class U>
+    U bezout_binary_shift(U a, unsigned z, U y, U yinv)
+    {
+        U m = U(U(U(0) - a) * yinv) & U((U(1) << z) - 1);     // a + m*y = 0 modulo 2^z
+        U R = 0;
+        if constexpr (sklib::bits_width_v<U> > sklib::bits_width_v<uint32_t>)
+        {
+            uint64_t hi, lo;
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(m, y, &hi, &lo);
+            sklib::priv::platform_AMD_x64::cpu_uadd128_64(hi, lo, 0, a, hi, lo);
+            R = (hi << (sklib::bits_width_v<uint64_t> - z)) | (lo >> z);
+        }
+        else
+        {
+            R = U((uint64_t(m) * y + a) >> z);
+        }
+        return (R >= y ? U(R - y) : R);
+    }
+
+    // see description above, A > 0, B > 0
+    template<class U>
+    U bezout_binary_unsigned(U A, U B, U& ka, U& kb)
+    {
+        unsigned shift = std::countr_zero(U(A | B));
+        U x = A >> shift;
+        U y = B >> shift;
+
+        bool swapped = !(y & 1);
+        if (swapped) std::swap(x, y);
+
+        U yinv = y;     // Newton's iteration, every step doubles number of correct bits (y*y=1 mod 8)
+        for (unsigned bits=3; bits<sklib::bits_width_v<U>; bits*=2) yinv = U(yinv * U(2 - U(y * yinv)));
+
+        // a*x = u, c*x = v (mod y); u and v are odd, the greater one is replaced by their difference divided by its
+        // power of 2; selections are written to avoid branches
+        U u = x, v = y, a = U(y > 1), c = 0;
+        if (unsigned z = std::countr_zero(u))
+        {
+            u >>= z;
+            a = bezout_binary_shift(a, z, y, yinv);
+        }
+
+        while (u != v)
+        {
+            bool greater = (u > v);
+            U d = (greater ? U(u - v) : U(v - u));
+            U p = (greater ? a : c);
+            U q = (greater ? c : a);
+            U e = (p >= q ? U(p - q) : U(p + (y - q)));
+
+            v = (greater ? v : u);
+            c = (greater ? c : a);
+            unsigned z = std::countr_zero(d);
+            u = d >> z;
+            a = bezout_binary_shift(e, z, y, yinv);
+        }
+
+        // x*a - y*t = u, t = (a*x - u) / y
+        U t = 0;
+        if (!a)
+        {
+            t = U(-1);      // u = y
+        }
+        else if constexpr (sklib::bits_width_v<U> > sklib::bits_width_v<uint32_t>)
+        {
+            uint64_t hi, lo;
+            sklib::priv::platform_AMD_x64::cpu_umul128_64(a, x, &hi, &lo);
+            sklib::priv::platform_AMD_x64::cpu_usub128_64(hi, lo, 0, u, hi, lo);
+            t = sklib::priv::platform_AMD_x64::cpu_udiv128_64(hi, lo, y, nullptr);
+        }
+        else
+        {
+            t = U((uint64_t(a) * x - u) / y);
+        }
+
+        ka = a;
+        kb = U(-t);
+        if (a > y / 2)
+        {
+            ka = U(a - y);
+            kb = U(x - t);
+        }
+
+        if (swapped) std::swap(ka, kb);
+        return U(u << shift);
+    }
+};
+
+// GCD of native integers; gcd(0,0) = 0
+//
+template<class T>
+constexpr SKLIB_TYPE_ENABLE_IF_NATIVE_INT(T, T) gcd(T A, T B)
+{
+    typedef std::make_unsigned_t<T> U;
+    U x = sklib::priv::bezout_native_abs(A);
+    U y = sklib::priv::bezout_native_abs(B);
+
+    if (!x || !y) return T(x | y);
+
+    // both odd; the greater one is replaced by their difference divided by its power of 2
+    unsigned shift = std::countr_zero(U(x | y));
+    x >>= std::countr_zero(x);
+    y >>= std::countr_zero(y);
+    while (x != y)
+    {
+        U d = (x > y ? U(x - y) : U(y - x));
+        y = (x > y ? y : x);
+        x = d >> std::countr_zero(d);
+    }
+    return T(x << shift);
+}
+
+// Extended Euclid's algorithm in native arithmetic, the coefficients are kept in registers
+//
+template<class T>
+SKLIB_TYPE_ENABLE_IF_NATIVE_INT(T, T) bezout(T A, T B, T& ka, T& kb)
+{
+    typedef std::make_unsigned_t<T> U;
+    U a = sklib::priv::bezout_native_abs(A);
+    U b = sklib::priv::bezout_native_abs(B);
+    U sa = 1, sb = 0, ta = 0, tb = 1;
+
+    while (b)
+    {
+        U q = U(a / b);
+        U r = U(a - q * b);
+        a = b;
+        b = r;
+
+        U s = U(sa - q * sb);
+        sa = sb;
+        sb = s;
+
+        U t = U(ta - q * tb);
+        ta = tb;
+        tb = t;
+    }
+
+    ka = T(sklib::aux::e_isnegative(A) ? U(-sa) : sa);
+    kb = T(sklib::aux::e_isnegative(B) ? U(-ta) : ta);
+    return T(a);
+}
+
+// Extended binary algorithm, same result as bezout(), except the coefficients may differ
+//
+template<class T>
+SKLIB_TYPE_ENABLE_IF_NATIVE_INT(T, T) bezout_binary(T A, T B, T& ka, T& kb)
+{
+    typedef std::make_unsigned_t<T> U;
+    U a = sklib::priv::bezout_native_abs(A);
+    U b = sklib::priv::bezout_native_abs(B);
+
+    U uka = U(!b), ukb = U(!!b);
+    U D = ((a && b) ? sklib::priv::bezout_binary_unsigned<U>(a, b, uka, ukb) : U(a | b));
+
+    ka = T(sklib::aux::e_isnegative(A) ? U(-uka) : uka);
+    kb = T(sklib::aux::e_isnegative(B) ? U(-ukb) : ukb);
+    return T(D);
+}
@@ -19,19 +19,40 @@ private:
     T V = 0;
     bool err = false;
 
+    const sklib::barrett_context_type<T>* B = nullptr;    // optional, reduction without division
+
     typedef sklib::priv::uint_extend<T> TT;
     typedef sklib::signed_uint<T> TS;
 
+    // multiplication by division, same interface as Barrett context, for modpow()
+    struct division_context_type
+    {
+        T P;
+
+        T mul(T A, T B) const
+        {
+            T R = 0;
+            sklib::priv::uint_extend_t<T> U(A);
+            U.mul(B).div(P, &R);
+            return R;
+        }
+
+        T one() const { return T(1); }
+    };
+
     void mmul(T x)
     {
         if (P<2)
         {
-            sklib::priv::uint_extend_t<T> U(V);
-            U.mul(x).div(P, &V);
+            err = true;
+        }
+        else if (B)
+        {
+            V = B->mul(V, x);
         }
         else
         {
-            err = true;
+            V = division_context_type{ P }.mul(V, x);
         }
     }
 
@@ -40,7 +61,11 @@ public:
     constexpr modp(const modp&) = default;
     constexpr modp() = default;
 
+    // the modulus is taken from Barrett context, which is referenced and must exist while the number is in use
+    modp(const sklib::barrett_context_type<T>& context, T value = 0) : modp(context.modulus(), value) { if (!err) B = &context; }
+
     bool is_valid() const { return (!err && P); }
+    T modulus() const { return P; }
 
     bool is_nonzero() const { return (is_valid() && V); }
     explicit operator bool() const { return is_nonzero(); }
@@ -51,7 +76,12 @@ public:
         {
             TS kP, kV;
             auto d = bezout(TS(P), TS(V), kP, kV);
-            if (d == 1 && kV) return { P, ((kV.sign()<0) ? T(P-kV.abs()) : kV.abs()) };
+            if (d == 1 && kV)
+            {
+                modp R(P, ((kV.sign()<0) ? T(P-kV.abs()) : kV.abs()));
+                R.B = B;
+                return R;
+            }
         }
 
         return { 0, 0 }; // it also makes err=true of the returned object
@@ -70,6 +100,14 @@ public:
         return *this;
     }
 
+    // X^e, by modpow() in Barrett context if the number has one
+    modp pow(uint64_t e) const
+    {
+        modp R(*this);
+        if (is_valid()) R.V = (B ? sklib::modpow(*B, V, e) : sklib::modpow(division_context_type{ P }, V, e));
+        return R;
+    }
+
     friend modp operator* (modp X, const modp& Y) { return X *= Y; }
     friend modp operator* (modp X, T Y) { return X *= Y; }
     friend modp operator* (T X, modp Y) { return Y *= X; }
@@ -86,6 +124,72 @@ public:
 //    }
 };
 
+// Replaces every element of the array by its reciprocal, same as reciprocal() does, but with single inversion
+// (Montgomery's trick): products of all prefixes, reciprocal of the whole product, and the pass backwards,
+// that is 3*(count-1) multiplications and one bezout() for all elements.
+// All elements shall have the same modulus as the first valid element; zero, invalid elements, and ones
+// with different modulus become invalid. If the modulus is composite and the product is not invertible,
+// the elements are inverted one by one. Returns true if all elements are inverted.
+//
+template<class T>
+bool modp_batch_inverse(sklib::modp<T>* data, size_t count)
+{
+    std::vector<sklib::modp<T>> prefix;
+    prefix.reserve(count);
+
+    T P = 0;
+    bool all = true;
+    for (size_t k=0; k<count; k++)
+    {
+        if (!P && data[k].is_valid()) P = data[k].modulus();
+        if (!data[k].is_nonzero() || data[k].modulus() != P)
+        {
+            data[k] = sklib::modp<T>();
+            all = false;
+            continue;
+        }
+
+        prefix.push_back(prefix.empty() ? data[k] : prefix.back() * data[k]);
+    }
+
+    if (prefix.empty()) return all;
+
+    auto inv = prefix.back().reciprocal();
+    if (!inv.is_valid())
+    {
+        for (size_t k=0; k<count; k++)
+        {
+            if (!data[k].is_valid()) continue;
+            data[k] = data[k].reciprocal();
+            if (!data[k].is_valid()) all = false;
+        }
+        return all;
+    }
+
+    // here, inv = 1/(x0*...*xn), and prefix[n-1] = x0*...*x(n-1)
+    for (size_t k=count, n=prefix.size(); k--; )
+    {
+        if (!data[k].is_valid()) continue;
+        if (!--n)
+        {
+            data[k] = inv;
+            break;
+        }
+
+        auto x = data[k];
+        data[k] = inv * prefix[n-1];
+        inv *= x;
+    }
+
+    return all;
+}
+
+template<class T>
+bool modp_batch_inverse(std::vector<sklib::modp<T>>& data)
+{
+    return modp_batch_inverse(data.data(), data.size());
+}
+
 // -------------------------------------------------------------------------------
 // Special field: A + B * sqrt(Q) mod P, where P - prime, Q - coprime with P,
 // and sum and product are formal in the sense (A mod P) + sqrt(Q) * (B mod P)
@@ -0,0 +1,104 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides benchmark of modular multiplication: plain modp, modp with Barrett context, Barrett context alone,
+// and Montgomery context, for 32-bit and 64-bit primes
+// This is internal SKLib file and must NOT be included directly.
+
+namespace priv
+{
+    inline constexpr uint32_t modp_benchmark_prime32 = 4294967291u;                 // largest 32-bit prime
+    inline constexpr uint64_t modp_benchmark_prime64 = 18446744073709551557ull;     // largest 64-bit prime
+
+    // Runs chain of dependent multiplications x = x*y mod P for every implementation, prints time per multiplication.
+    // Returns false if the implementations don't agree on the result.
+    template<class T>
+    bool modp_benchmark_run(T prime, size_t count, const char* width)
+    {
+        typedef std::chrono::steady_clock clock;
+
+        std::mt19937_64 rnd(1);
+        const T x0 = T(rnd() % prime);
+        const T y = T(rnd() % prime);
+
+        auto measure = [count](auto&& task)
+        {
+            auto start = clock::now();
+            T R = task();
+            double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / double(count);
+            return std::make_pair(R, ns);
+        };
+
+        auto print = [width](const char* title, double ns)
+        {
+            std::cout << std::left << std::setw(24) << title << std::right << std::setw(8) << width
+                      << std::setw(12) << std::fixed << std::setprecision(2) << ns << " ns\n";
+        };
+
+        const sklib::barrett_context_type<T> B(prime);
+        const sklib::montgomery_context_type<T> M(prime);
+
+        auto plain = measure([&]()
+        {
+            sklib::modp<T> X(prime, x0);
+            for (size_t k=0; k<count; k++) X *= y;
+            return X();
+        });
+
+        auto with_barrett = measure([&]()
+        {
+            sklib::modp<T> X(B, x0);
+            for (size_t k=0; k<count; k++) X *= y;
+            return X();
+        });
+
+        auto barrett = measure([&]()
+        {
+            T X = x0;
+            for (size_t k=0; k<count; k++) X = B.mul(X, y);
+            return X;
+        });
+
+        auto montgomery = measure([&]()
+        {
+            T X = M.to(x0);
+            const T Y = M.to(y);
+            for (size_t k=0; k<count; k++) X = M.mul(X, Y);
+            return M.from(X);
+        });
+
+        print("modp", plain.second);
+        print("modp, Barrett context", with_barrett.second);
+        print("Barrett context", barrett.second);
+        print("Montgomery context", montgomery.second);
+
+        return (plain.first == with_barrett.first && plain.first == barrett.first && plain.first == montgomery.first);
+    }
+};
+
+namespace aux
+{
+    // Measures modular multiplication by every implementation: plain modp (division), modp referencing Barrett
+    // context, Barrett context alone, and Montgomery context (conversion excluded), for the largest 32-bit and
+    // 64-bit primes. Each measurement is a chain of count dependent multiplications. Prints the table.
+    // Returns false if the results differ.
+    //
+    inline bool modp_benchmark(size_t count = size_t(20) << 20)
+    {
+        std::cout << std::left << std::setw(24) << "Modular multiplication" << std::right << std::setw(8) << "bits"
+                  << std::setw(15) << "time" << "\n";
+
+        bool ok = sklib::priv::modp_benchmark_run<uint32_t>(sklib::priv::modp_benchmark_prime32, count, "32");
+        ok = sklib::priv::modp_benchmark_run<uint64_t>(sklib::priv::modp_benchmark_prime64, count, "64") && ok;
+
+        if (!ok) std::cout << "Modular multiplication mismatch\n";
+        return ok;
+    }
+};
@@ -0,0 +1,186 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides modular exponentiation in Montgomery or Barrett context. Reference: https://en.wikipedia.org/wiki/Exponentiation_by_squaring
+// This is internal SKLib file and must NOT be included directly.
+
+// The context is montgomery_context_type, barrett_context_type, or any other class that has mul() and one();
+// numbers are in the form of the context. There are three methods, for different kinds of work:
+//   modpow() - single exponentiation, when the time is bound by latency. The exponent is scanned from the low end:
+//     the squares of A make the only chain of dependent multiplications, and multiplications of the result go aside,
+//     so the time is about one multiplication latency per bit. The result is selected, not branched on.
+//   modpow_window() - sliding window, from the high end; fewest multiplications, all of them on the dependent chain,
+//     so it is for the contexts where multiplication is expensive compared to its latency.
+//   modpow_interleaved() - several exponentiations in step, when the time is bound by throughput: fixed windows,
+//     no branches, and independent multiplications of different lanes fill the CPU pipeline.
+// The window width is chosen from the bit length of the exponent, to minimize the number of multiplications.
+// When the exponent is known at compile time, the chain is unrolled by the compiler: no loop, no selection,
+// and only the multiplications for bits that are set.
+
+namespace priv
+{
+    inline constexpr unsigned modpow_window_max = 5;
+
+    // sliding window: 2^(w-1) multiplications for odd powers, and about bits/(w+1) multiplications by them
+    constexpr unsigned modpow_sliding_window(unsigned bits)
+    {
+        return (bits > 79 ? 4 : (bits > 23 ? 3 : (bits > 7 ? 2 : 1)));
+    }
+
+    // fixed window: 2^w-2 multiplications for the table, and bits/w multiplications by it
+    constexpr unsigned modpow_fixed_window(unsigned bits)
+    {
+        unsigned best = 1;
+        for (unsigned w=2; w<=modpow_window_max; w++)
+        {
+            if ((1u << w) - 2 + (bits + w - 1) / w < (1u << best) - 2 + (bits + best - 1) / best) best = w;
+        }
+        return best;
+    }
+
+    // R * A^E, R is not used until the first set bit
+    template<uint64_t E, bool started, class C, class T>
+    constexpr T modpow_unrolled(const C& M, T A, T R)
+    {
+        if constexpr (E & 1)
+        {
+            if constexpr (started) R = M.mul(R, A);
+            else R = A;
+        }
+
+        if constexpr (E > 1) return modpow_unrolled<(E >> 1), (started || (E & 1))>(M, M.mul(A, A), R);
+        else return R;
+    }
+};
+
+// A^e in the context
+//
+template<class C, class T>
+constexpr T modpow(const C& M, T A, uint64_t e)
+{
+    T R = M.one();
+    for (; e; e >>= 1)
+    {
+        T P = M.mul(R, A);
+        R = ((e & 1) ? P : R);
+        if (e == 1) break;
+        A = M.mul(A, A);
+    }
+    return R;
+}
+
+// A^E in the context, for exponent known at compile time
+//
+template<uint64_t E, class C, class T>
+constexpr T modpow(const C& M, T A)
+{
+    if constexpr (!E) return M.one();
+    else return sklib::priv::modpow_unrolled<E, false>(M, A, A);
+}
+
+// A^e in the context, by sliding window
+//
+template<class C, class T>
+T modpow_window(const C& M, T A, uint64_t e)
+{
+    if (!e) return M.one();
+
+    int top = int(std::bit_width(e)) - 1;
+    unsigned w = sklib::priv::modpow_sliding_window(unsigned(top + 1));
+
+    // odd[j] = A^(2j+1)
+    T odd[size_t(1) << (sklib::priv::modpow_window_max - 1)];
+    odd[0] = A;
+    T A2 = M.mul(A, A);
+    for (unsigned j=1; j<(1u << (w - 1)); j++) odd[j] = M.mul(odd[j-1], A2);
+
+    T R = M.one();
+    bool started = false;
+    for (int i=top; i>=0; )
+    {
+        if (!((e >> i) & 1))
+        {
+            R = M.mul(R, R);
+            i--;
+            continue;
+        }
+
+        // the longest window from bit i down, that ends with set bit
+        int low = sklib::priv::alt_max(i - int(w) + 1, 0);
+        while (!((e >> low) & 1)) low++;
+        unsigned value = unsigned((e >> low) & ((uint64_t(1) << (i - low + 1)) - 1));
+
+        if (started)
+        {
+            for (int k=low; k<=i; k++) R = M.mul(R, R);
+            R = M.mul(R, odd[value >> 1]);
+        }
+        else
+        {
+            R = odd[value >> 1];
+            started = true;
+        }
+        i = low - 1;
+    }
+    return R;
+}
+
+// R[k] = A[k]^e[k] in context M[k], k < L, all lanes in step, by fixed window
+//
+template<unsigned L, class C, class T>
+void modpow_interleaved(const C* M, const T* A, const uint64_t* e, T* R)
+{
+    C Mc[L];            // local copies, so the compiler can keep all lanes in registers
+    uint64_t d[L];
+    uint64_t max_e = 0;
+    for (unsigned k=0; k<L; k++)
+    {
+        Mc[k] = M[k];
+        d[k] = e[k];
+        max_e = sklib::priv::alt_max(max_e, d[k]);
+    }
+
+    unsigned bits = unsigned(std::bit_width(max_e));
+    if (!bits)
+    {
+        for (unsigned k=0; k<L; k++) R[k] = Mc[k].one();
+        return;
+    }
+
+    const unsigned w = sklib::priv::modpow_fixed_window(bits);
+    const uint64_t mask = (uint64_t(1) << w) - 1;
+
+    T power[L][size_t(1) << sklib::priv::modpow_window_max];     // A^0 ... A^(2^w-1)
+    for (unsigned k=0; k<L; k++)
+    {
+        power[k][0] = Mc[k].one();
+        power[k][1] = A[k];
+    }
+    for (unsigned j=2; j<=mask; j++)
+    {
+        for (unsigned k=0; k<L; k++) power[k][j] = Mc[k].mul(power[k][j-1], power[k][1]);
+    }
+
+    // left-to-right, the first window is taken from the table
+    unsigned bit = (bits - 1) / w * w;
+    T x[L];
+    for (unsigned k=0; k<L; k++) x[k] = power[k][(d[k] >> bit) & mask];
+    while (bit)
+    {
+        bit -= w;
+        for (unsigned j=0; j<w; j++)
+        {
+            for (unsigned k=0; k<L; k++) x[k] = Mc[k].mul(x[k], x[k]);
+        }
+        for (unsigned k=0; k<L; k++) x[k] = Mc[k].mul(x[k], power[k][(d[k] >> bit) & mask]);
+    }
+
+    for (unsigned k=0; k<L; k++) R[k] = x[k];
+}
@@ -0,0 +1,202 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides Montgomery modular multiplication. Reference: https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
+// This is internal SKLib file and must NOT be included directly.
+
+// For odd modulus N and R = 2^(bit width of T), number x is represented by x*R mod N ("Montgomery form").
+// Product of two numbers in Montgomery form is reduced by REDC() that only needs multiplications and
+// one conditional addition, no division. 64-bit version uses 128-bit product from cpu-support.hpp.
+
+namespace priv
+{
+    // full product of two integers, high and low halves
+    inline void montgomery_mul_wide(uint64_t A, uint64_t B, uint64_t& hi, uint64_t& lo)
+    {
+        sklib::priv::platform_AMD_x64::cpu_umul128_64(A, B, &hi, &lo);
+    }
+
+    inline void montgomery_mul_wide(uint32_t A, uint32_t B, uint32_t& hi, uint32_t& lo)
+    {
+        uint64_t M = uint64_t(A) * B;
+        hi = uint32_t(M >> sklib::bits_width_v<uint32_t>);
+        lo = uint32_t(M);
+    }
+
+    // remainder of (hi:lo) divided by N, hi < N
+    inline uint64_t montgomery_mod_wide(uint64_t hi, uint64_t lo, uint64_t N)
+    {
+        uint64_t R = 0;
+        sklib::priv::platform_AMD_x64::cpu_udiv128_64(hi, lo, N, &R);
+        return R;
+    }
+
+    inline uint32_t montgomery_mod_wide(uint32_t hi, uint32_t lo, uint32_t N)
+    {
+        return uint32_t(((uint64_t(hi) << sklib::bits_width_v<uint32_t>) | lo) % N);
+    }
+};
+
+// Modulus context: all numbers passed to and returned by mul(), add(), sub(), pow() are in Montgomery form.
+// Use to() and from() to convert regular numbers. The modulus must be odd and greater than 1.
+//
+template<class T>
+class montgomery_context_type
+{
+    static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>, "Montgomery context is defined for uint32_t and uint64_t");
+
+public:
+    typedef T data_type;
+
+    montgomery_context_type() = default;
+
+    explicit montgomery_context_type(T modulus)
+        : N(modulus)
+    {
+        if (!is_valid()) return;
+
+        // N^-1 modulo 2^width by Newton's iteration, every step doubles number of correct bits (N*N=1 mod 8)
+        Ninv = N;
+        for (unsigned bits=3; bits<sklib::bits_width_v<T>; bits*=2) Ninv *= T(2) - N * Ninv;
+
+        R1 = sklib::priv::montgomery_mod_wide(T(1), T(0), N);   // 2^width mod N
+        T hi, lo;
+        sklib::priv::montgomery_mul_wide(R1, R1, hi, lo);
+        R2 = sklib::priv::montgomery_mod_wide(hi, lo, N);      // 2^(2*width) mod N
+    }
+
+    bool is_valid() const { return (N > 1 && (N & 1)); }
+    T modulus() const { return N; }
+
+    // Montgomery reduction: (hi:lo) * R^-1 mod N, requires hi < N
+    T redc(T hi, T lo) const
+    {
+        T m = lo * Ninv;
+        T mhi, mlo;
+        sklib::priv::montgomery_mul_wide(m, N, mhi, mlo);   // mlo == lo by construction of m
+        return hi - mhi + (hi < mhi ? N : T(0));
+    }
+
+    T mul(T A, T B) const
+    {
+        T hi, lo;
+        sklib::priv::montgomery_mul_wide(A, B, hi, lo);
+        return redc(hi, lo);
+    }
+
+    T add(T A, T B) const { return (A >= N - B ? A - (N - B) : A + B); }
+    T sub(T A, T B) const { return (A >= B ? A - B : A + (N - B)); }
+
+    T to(T x) const { return mul(x % N, R2); }
+    T from(T A) const { return redc(T(0), A); }
+
+    T one() const { return R1; }                // 1 in Montgomery form
+    T minus_one() const { return N - R1; }      // N-1 in Montgomery form
+
+    // A^e, A is in Montgomery form
+    T pow(T A, uint64_t e) const { return sklib::modpow(*this, A, e); }
+
+private:
+    T N = 0;
+    T Ninv = 0;     // N^-1 mod 2^width
+    T R1 = 0;       // 2^width mod N
+    T R2 = 0;       // 2^(2*width) mod N
+};
+
+// Element of the ring modulo N of the context, kept in Montgomery form; the context is referenced, not copied, and it
+// must exist while the element is in use. Conversion from and to regular numbers is made only by the constructor and
+// operator(), all arithmetic stays in Montgomery form. Elements of different contexts can be combined if the moduli
+// are equal, otherwise the result is invalid, same as the element without context.
+// Inverse is found by bezout() through modp, and it exists when the element is coprime with N.
+//
+template<class T>
+class modp_montgomery
+{
+public:
+    typedef T data_type;
+    typedef sklib::montgomery_context_type<T> context_type;
+
+    constexpr modp_montgomery() = default;
+    constexpr modp_montgomery(const modp_montgomery&) = default;
+
+    modp_montgomery(const context_type& context, T value = 0)
+        : M(context.is_valid() ? &context : nullptr)
+        , V(context.is_valid() ? context.to(value) : T(0))
+    {}
+
+    // from modp, its modulus must be the same as of the context
+    modp_montgomery(const context_type& context, const sklib::modp<T>& X)
+        : modp_montgomery(context, X())
+    {
+        if (!X.is_valid() || X.modulus() != context.modulus()) M = nullptr;
+    }
+
+    // from the number that is already in Montgomery form
+    static modp_montgomery from_montgomery(const context_type& context, T A)
+    {
+        modp_montgomery R(context);
+        R.V = A;
+        return R;
+    }
+
+    bool is_valid() const { return (M != nullptr); }
+    bool is_nonzero() const { return (is_valid() && V); }
+    explicit operator bool() const { return is_nonzero(); }
+
+    const context_type* context() const { return M; }
+    T modulus() const { return (M ? M->modulus() : T(0)); }
+    T montgomery() const { return V; }
+
+    T operator() () const { return (M ? M->from(V) : T(0)); }
+    sklib::modp<T> to_modp() const { return (M ? sklib::modp<T>(M->modulus(), (*this)()) : sklib::modp<T>()); }
+
+    modp_montgomery& operator+= (const modp_montgomery& X) { if (join(X)) V = M->add(V, X.V); return *this; }
+    modp_montgomery& operator-= (const modp_montgomery& X) { if (join(X)) V = M->sub(V, X.V); return *this; }
+    modp_montgomery& operator*= (const modp_montgomery& X) { if (join(X)) V = M->mul(V, X.V); return *this; }
+
+    friend modp_montgomery operator+ (modp_montgomery X, const modp_montgomery& Y) { return X += Y; }
+    friend modp_montgomery operator- (modp_montgomery X, const modp_montgomery& Y) { return X -= Y; }
+    friend modp_montgomery operator* (modp_montgomery X, const modp_montgomery& Y) { return X *= Y; }
+    friend modp_montgomery operator- (modp_montgomery X) { if (X.M) X.V = X.M->sub(T(0), X.V); return X; }
+
+    friend bool operator== (const modp_montgomery& X, const modp_montgomery& Y) { return (X.modulus() == Y.modulus() && X.V == Y.V); }
+    friend bool operator!= (const modp_montgomery& X, const modp_montgomery& Y) { return !(X == Y); }
+
+    modp_montgomery pow(uint64_t e) const
+    {
+        modp_montgomery R(*this);
+        if (M) R.V = sklib::modpow(*M, V, e);
+        return R;
+    }
+
+    modp_montgomery reciprocal() const
+    {
+        if (is_nonzero())
+        {
+            auto R = to_modp().reciprocal();
+            if (R.is_valid()) return modp_montgomery(*M, R());
+        }
+
+        return modp_montgomery();
+    }
+
+    friend modp_montgomery operator/ (const modp_montgomery& X, const modp_montgomery& Y) { return X * Y.reciprocal(); }
+
+private:
+    const context_type* M = nullptr;
+    T V = 0;
+
+    // true if the operation can proceed, otherwise invalidates the result
+    bool join(const modp_montgomery& X)
+    {
+        if (M != X.M && (!M || !X.M || M->modulus() != X.M->modulus())) M = nullptr;
+        return (M != nullptr);
+    }
+};
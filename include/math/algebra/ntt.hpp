@@ -0,0 +1,357 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides number-theoretic transform (NTT) and fast multiplication of polynomials modulo prime.
+// Reference: https://en.wikipedia.org/wiki/Number-theoretic_transform
+// This is internal SKLib file and must NOT be included directly.
+
+// Transform of length 2^k modulo prime P requires 2^k to divide P-1, for example: 998244353 = 119*2^23+1,
+// 167772161 = 5*2^25+1, 469762049 = 7*2^26+1, 0xFFFFFFFF00000001 = (2^32-1)*2^32+1.
+// The transform is iterative and in place: the data is permuted into bit-reversed order (large arrays by tiles,
+// so that both sides of the exchange stay in cache, instead of scattered swaps), then it is processed by
+// radix-4 passes (two radix-2 levels at once, so half the passes over memory), with one radix-2 pass first when k is odd.
+// Roots of unity (twiddles) are precomputed in Montgomery form, for every level in a separate contiguous table,
+// so every pass reads them sequentially. The transform is linear, and multiplication by twiddle in Montgomery form
+// preserves form of the data: it can be either regular numbers below P, or Montgomery form, see montgomery.hpp.
+// Passes of large transforms are split between threads, threads=0 means all available CPU cores.
+
+namespace priv
+{
+    // don't give a thread less than this number of butterflies in the pass
+    inline constexpr size_t ntt_parallel_min = size_t(1) << 14;
+
+    // bit reversal of the array longer than one tile is done by square tiles of 2^tile_log by 2^tile_log elements
+    inline constexpr unsigned ntt_reverse_tile_log = 4;
+
+    // number of quadratic nonresidues to try when looking for root of unity
+    inline constexpr unsigned ntt_nonresidue_search = 1 << 10;
+
+    // primes for polynomial_multiply_crt(), all support length up to 2^23
+    inline constexpr uint32_t ntt_crt_primes[] = { 998244353, 167772161, 469762049 };
+    inline constexpr unsigned ntt_crt_max_log = 23;
+};
+
+// Context of transform modulo prime, up to length 2^max_log. The context is invalid if the modulus is not
+// an odd prime, or if 2^max_log doesn't divide P-1.
+//
+template<class T>
+class ntt_context_type
+{
+public:
+    typedef T data_type;
+    typedef sklib::montgomery_context_type<T> modulus_type;
+
+    ntt_context_type() = default;
+
+    ntt_context_type(T prime, unsigned max_log)
+        : M(prime)
+    {
+        if (!M.is_valid() || max_log >= sklib::bits_width_v<T>) return;
+
+        // P-1 = Q * 2^S; for nonresidue a, a^Q has order 2^S exactly
+        T Q = prime - 1;
+        unsigned S = 0;
+        for (; !(Q & 1); Q >>= 1) S++;
+        if (max_log > S) return;
+
+        T root = 0;
+        for (unsigned a=2; a<sklib::priv::ntt_nonresidue_search && a<prime; a++)
+        {
+            T A = M.to(T(a));
+            if (M.pow(A, (prime - 1) / 2) == M.minus_one())
+            {
+                root = M.pow(A, Q);
+                break;
+            }
+        }
+        if (!root) return;
+
+        for (unsigned k=max_log; k<S; k++) root = M.mul(root, root);     // order 2^max_log
+        T root_inv = M.pow(root, (uint64_t(1) << max_log) - 1);
+
+        log_max = max_log;
+        roots.resize(size_t(1) << max_log);
+        roots_inv.resize(size_t(1) << max_log);
+        generate(roots, root);
+        generate(roots_inv, root_inv);
+        valid = true;
+    }
+
+    bool is_valid() const { return valid; }
+    unsigned max_log() const { return log_max; }
+    size_t max_length() const { return (valid ? size_t(1) << log_max : 0); }
+    const modulus_type& montgomery() const { return M; }
+    T modulus() const { return M.modulus(); }
+
+    // In-place transform of 2^log_length numbers below P. Returns false if the length is not supported.
+    bool forward(T* data, unsigned log_length, unsigned threads = 0) const
+    {
+        if (!valid || log_length > log_max) return false;
+        transform(data, log_length, roots, threads);
+        return true;
+    }
+
+    // In-place inverse transform, including division by the length.
+    bool inverse(T* data, unsigned log_length, unsigned threads = 0) const
+    {
+        if (!valid || log_length > log_max) return false;
+        transform(data, log_length, roots_inv, threads);
+
+        // 1/n in Montgomery form
+        T scale = M.pow(M.to(T(size_t(1) << log_length)), uint64_t(M.modulus() - 2));
+        run(size_t(1) << log_length, threads, [&](size_t begin, size_t end)
+        {
+            const modulus_type C = M;
+            for (size_t k=begin; k<end; k++) data[k] = C.mul(data[k], scale);
+        });
+        return true;
+    }
+
+    // Product of polynomials, coefficients are in order of powers of x and are taken modulo P; the result has
+    // A.size()+B.size()-1 coefficients below P, or empty if either operand is empty. False if too long for the context.
+    template<class V>
+    bool multiply(const std::vector<V>& A, const std::vector<V>& B, std::vector<T>& R, unsigned threads = 0) const
+    {
+        R.clear();
+        if (!valid) return false;
+        if (A.empty() || B.empty()) return true;
+
+        size_t length = A.size() + B.size() - 1;
+        unsigned log_length = 0;
+        while ((size_t(1) << log_length) < length) log_length++;
+        if (log_length > log_max) return false;
+
+        // one operand in Montgomery form, so the pointwise product comes out in regular form
+        std::vector<T> FA(size_t(1) << log_length, 0);
+        R.assign(size_t(1) << log_length, 0);
+        for (size_t k=0; k<A.size(); k++) FA[k] = M.to(T(A[k] % M.modulus()));
+        for (size_t k=0; k<B.size(); k++) R[k] = T(B[k] % M.modulus());
+
+        transform(FA.data(), log_length, roots, threads);
+        transform(R.data(), log_length, roots, threads);
+        T* Y = R.data();
+        run(R.size(), threads, [&](size_t begin, size_t end)
+        {
+            const modulus_type C = M;
+            for (size_t k=begin; k<end; k++) Y[k] = C.mul(FA[k], Y[k]);
+        });
+        inverse(R.data(), log_length, threads);
+
+        R.resize(length);
+        return true;
+    }
+
+private:
+    modulus_type M;
+    bool valid = false;
+    unsigned log_max = 0;
+    std::vector<T> roots;       // for L = 2, 4, 8..., roots[L/2 + j] = w^j, j < L/2, w is root of unity of order L
+    std::vector<T> roots_inv;   // same for the inverse roots
+
+    void generate(std::vector<T>& table, T root) const
+    {
+        // primitive roots of order 2^level, from the top
+        std::vector<T> level_root(log_max + 1, M.one());
+        if (log_max) level_root[log_max] = root;
+        for (unsigned k=log_max; k>1; k--) level_root[k-1] = M.mul(level_root[k], level_root[k]);
+
+        for (unsigned k=1; k<=log_max; k++)
+        {
+            size_t half = size_t(1) << (k-1);
+            table[half] = M.one();
+            for (size_t j=1; j<half; j++) table[half + j] = M.mul(table[half + j - 1], level_root[k]);
+        }
+    }
+
+    template<class F>
+    static void run(size_t count, unsigned threads, F&& body)
+    {
+        sklib::aux::parallel_split_type split(count, 1, sklib::priv::ntt_parallel_min, threads);
+        split.run([&body](unsigned, size_t begin, size_t end) { body(begin, end); });
+    }
+
+    // bit-reversal permutation
+    static void reverse(T* data, unsigned log_length, unsigned threads)
+    {
+        constexpr unsigned tile_log = sklib::priv::ntt_reverse_tile_log;
+        constexpr size_t side = size_t(1) << tile_log;
+        const size_t n = size_t(1) << log_length;
+
+        if (log_length <= 2*tile_log)
+        {
+            // every pair is swapped by the thread that owns its lower index
+            unsigned shift = sklib::bits_width_v<size_t> - log_length;
+            run(n, threads, [&](size_t begin, size_t end)
+            {
+                for (size_t k=begin; k<end; k++)
+                {
+                    size_t r = sklib::bits_flip<size_t>(k) >> shift;
+                    if (k < r) std::swap(data[k], data[r]);
+                }
+            });
+            return;
+        }
+
+        // index is (hi:mid:lo), where hi and lo are tile_log bits; the reversed index is (rev lo:rev mid:rev hi),
+        // so the tile of all hi and lo for the given mid is exchanged with the tile for rev mid, and transposed;
+        // every tile row is contiguous, and both tiles are copied to local buffers
+        const unsigned mid_log = log_length - 2*tile_log;
+        const unsigned mid_shift = sklib::bits_width_v<size_t> - mid_log;
+        const size_t stride = size_t(1) << (mid_log + tile_log);
+
+        size_t flip[side];
+        for (size_t k=0; k<side; k++) flip[k] = sklib::bits_flip<size_t>(k) >> (sklib::bits_width_v<size_t> - tile_log);
+
+        // every pair of tiles is exchanged by the thread that owns its lower mid
+        run(size_t(1) << mid_log, threads, [&](size_t begin, size_t end)
+        {
+            T A[side * side], B[side * side];
+            for (size_t mid=begin; mid<end; mid++)
+            {
+                size_t rmid = sklib::bits_flip<size_t>(mid) >> mid_shift;
+                if (rmid < mid) continue;
+
+                T* X = data + (mid << tile_log);
+                T* Y = data + (rmid << tile_log);
+                for (size_t hi=0; hi<side; hi++)
+                {
+                    for (size_t lo=0; lo<side; lo++)
+                    {
+                        A[hi*side + lo] = X[hi*stride + lo];
+                        B[hi*side + lo] = Y[hi*stride + lo];
+                    }
+                }
+                for (size_t hi=0; hi<side; hi++)
+                {
+                    for (size_t lo=0; lo<side; lo++)
+                    {
+                        X[hi*stride + lo] = B[flip[lo]*side + flip[hi]];
+                        Y[hi*stride + lo] = A[flip[lo]*side + flip[hi]];
+                    }
+                }
+            }
+        });
+    }
+
+    void transform(T* data, unsigned log_length, const std::vector<T>& table, unsigned threads) const
+    {
+        if (!log_length) return;
+        size_t n = size_t(1) << log_length;
+
+        reverse(data, log_length, threads);
+
+        const T* w = table.data();
+        unsigned level = 0;
+
+        if (log_length & 1)
+        {
+            run(n/2, threads, [&](size_t begin, size_t end)
+            {
+                const modulus_type C = M;
+                for (size_t t=begin; t<end; t++)
+                {
+                    T* x = data + 2*t;
+                    T a0 = x[0], a1 = x[1];
+                    x[0] = C.add(a0, a1);
+                    x[1] = C.sub(a0, a1);
+                }
+            });
+            level = 1;
+        }
+
+        // two levels: blocks of 2*len with twiddles w[len+j], then blocks of 4*len with w[2*len+j] and w[3*len+j]
+        for (; level<log_length; level+=2)
+        {
+            size_t len = size_t(1) << level;
+            run(n/4, threads, [&](size_t begin, size_t end)
+            {
+                // local copy of the context, so stores to data don't force reloading it
+                const modulus_type C = M;
+
+                // inner loop runs over consecutive positions in one block
+                for (size_t t=begin; t<end; )
+                {
+                    size_t first = t & (len - 1);
+                    size_t stop = sklib::priv::alt_min(end - t + first, len);
+                    T* x = data + ((t >> level) << (level + 2));
+                    T* x1 = x + len;
+                    T* x2 = x + 2*len;
+                    T* x3 = x + 3*len;
+                    const T* w1 = w + len;
+                    const T* w2 = w + 2*len;
+                    const T* w3 = w + 3*len;
+
+                    for (size_t j=first; j<stop; j++)
+                    {
+                        T a0 = x[j];
+                        T a1 = C.mul(x1[j], w1[j]);
+                        T a2 = x2[j];
+                        T a3 = C.mul(x3[j], w1[j]);
+
+                        T b0 = C.add(a0, a1);
+                        T b1 = C.sub(a0, a1);
+                        T b2 = C.mul(C.add(a2, a3), w2[j]);
+                        T b3 = C.mul(C.sub(a2, a3), w3[j]);
+
+                        x[j] = C.add(b0, b2);
+                        x2[j] = C.sub(b0, b2);
+                        x1[j] = C.add(b1, b3);
+                        x3[j] = C.sub(b1, b3);
+                    }
+
+                    t += stop - first;
+                }
+            });
+        }
+    }
+};
+
+// Product of polynomials with nonnegative integer coefficients, by transforms modulo three primes and Chinese
+// remainder theorem (Garner's algorithm). The result is exact modulo 2^64, if every coefficient of the exact product
+// is below the product of the primes (about 2^86). The result has A.size()+B.size()-1 coefficients, or empty if
+// either operand is empty. Returns false if the result is longer than 2^23.
+//
+inline bool polynomial_multiply_crt(const std::vector<uint64_t>& A, const std::vector<uint64_t>& B,
+                                    std::vector<uint64_t>& R, unsigned threads = 0)
+{
+    using sklib::priv::ntt_crt_primes;
+
+    R.clear();
+    if (A.empty() || B.empty()) return true;
+
+    size_t length = A.size() + B.size() - 1;
+    unsigned log_length = 0;
+    while ((size_t(1) << log_length) < length) log_length++;
+    if (log_length > sklib::priv::ntt_crt_max_log) return false;
+
+    std::vector<uint32_t> C[std::size(ntt_crt_primes)];
+    for (size_t k=0; k<std::size(ntt_crt_primes); k++)
+    {
+        sklib::ntt_context_type<uint32_t> Context(ntt_crt_primes[k], log_length);
+        if (!Context.multiply(A, B, C[k], threads)) return false;
+    }
+
+    const uint64_t m0 = ntt_crt_primes[0], m1 = ntt_crt_primes[1], m2 = ntt_crt_primes[2];
+    sklib::barrett_context_type<uint64_t> M1(m1), M2(m2);
+    const uint64_t inv_m0 = M1.pow(m0 % m1, m1 - 2);                 // 1/m0 mod m1
+    const uint64_t inv_m0m1 = M2.pow(M2.mul(m0 % m2, m1 % m2), m2 - 2);  // 1/(m0*m1) mod m2
+
+    R.resize(length);
+    for (size_t k=0; k<length; k++)
+    {
+        // x = t0 + t1*m0 + t2*m0*m1
+        uint64_t t0 = C[0][k];
+        uint64_t t1 = M1.mul(M1.sub(C[1][k], t0 % m1), inv_m0);
+        uint64_t t2 = M2.mul(M2.sub(C[2][k], M2.add(t0 % m2, M2.mul(t1 % m2, m0 % m2))), inv_m0m1);
+        R[k] = t0 + t1*m0 + t2*m0*m1;
+    }
+
+    return true;
+}
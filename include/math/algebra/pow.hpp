@@ -39,3 +39,47 @@ constexpr auto ipow(R x, V p)
     return (p<0) ? upow(1/x, (uV)-p) : upow(x, (uV)p);
 }
 
+
+// integer square root: the greatest R such that R*R <= x
+template<class T>
+constexpr SKLIB_TYPE_ENABLE_IF_NATIVE_UINT(T, T) usqrt(T x)
+{
+    T R = 0;
+    T bit = T(1) << (sklib::bits_width_v<T> - 2);
+    while (bit > x) bit >>= 2;
+
+    while (bit)
+    {
+        if (x >= R + bit)
+        {
+            x -= R + bit;
+            R = (R >> 1) + bit;
+        }
+        else
+        {
+            R >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return R;
+}
+
+// integer cube root: the greatest R such that R*R*R <= x
+template<class T>
+constexpr SKLIB_TYPE_ENABLE_IF_NATIVE_UINT(T, T) ucbrt(T x)
+{
+    T R = 0;
+    for (int shift = (sklib::bits_width_v<T> - 1) / 3 * 3; shift >= 0; shift -= 3)
+    {
+        R <<= 1;
+        T b = T(3) * R * (R + 1) + 1;
+        if ((x >> shift) >= b)
+        {
+            x -= b << shift;
+            R++;
+        }
+    }
+
+    return R;
+}
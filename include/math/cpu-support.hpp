@@ -18,7 +18,10 @@
 #define SKLIB_INTERNAL_PLATFORM_GCC_X64
 #else
 #undef SKLIB_INTERNAL_PLATFORM_KNOWN_X64
-//static_assert(false, "ERROR ** SKLib only supports 128-64 operations on x64 architecture and for GNU C++ or MSVC compilers");
+#endif
+
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+#define SKLIB_INTERNAL_PLATFORM_GCC_INT128
 #endif
 
 namespace priv
@@ -33,10 +36,80 @@ namespace priv
         return A / B;   //sk TODO: rewrite in explicit assembly form?
     }
 
-    namespace platform_AMD_x64
+    // Portable implementation of 128-64 operations, for any CPU and compiler
+    // The 64-bit values are split into 32-bit halves, see Knuth, TAOCP vol. 2, 4.3.1
+    namespace platform_portable
     {
+        inline constexpr uint64_t half_mask = 0xFFFFFFFF;
+        inline constexpr unsigned half_bits = 32;
 
-#ifdef SKLIB_INTERNAL_PLATFORM_KNOWN_X64
+        // Quotent must fit 64-bit, that is, Ahi < B
+        inline uint64_t cpu_udiv128_64(uint64_t Ahi, uint64_t Alo, uint64_t B, uint64_t* R)
+        {
+            // normalize, so the leading bit of B is set
+            unsigned s = 0;
+            while (s < 63 && !(B >> 63)) { B <<= 1; s++; }
+            if (s)
+            {
+                Ahi = (Ahi << s) | (Alo >> (64 - s));
+                Alo <<= s;
+            }
+
+            const uint64_t b1 = B >> half_bits, b0 = B & half_mask;
+            const uint64_t a1 = Alo >> half_bits, a0 = Alo & half_mask;
+
+            // each digit of quotent is estimated by the leading digit of B, and is corrected by at most 2
+            auto digit = [b1, b0](uint64_t U, uint64_t next) -> uint64_t
+            {
+                uint64_t q = U / b1, r = U - q * b1;
+                while (q > half_mask || q * b0 > ((r << half_bits) | next))
+                {
+                    q--;
+                    r += b1;
+                    if (r > half_mask) break;
+                }
+                return q;
+            };
+
+            uint64_t q1 = digit(Ahi, a1);
+            uint64_t U = (Ahi << half_bits) + a1 - q1 * B;      // exact modulo 2^64, because the value is below B
+            uint64_t q0 = digit(U, a0);
+
+            if (R) *R = ((U << half_bits) + a0 - q0 * B) >> s;
+            return (q1 << half_bits) | q0;
+        }
+
+        inline void cpu_umul128_64(uint64_t A, uint64_t B, uint64_t* Mhi, uint64_t* Mlo)
+        {
+            const uint64_t a1 = A >> half_bits, a0 = A & half_mask;
+            const uint64_t b1 = B >> half_bits, b0 = B & half_mask;
+            const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+            const uint64_t mid = (p00 >> half_bits) + (p01 & half_mask) + (p10 & half_mask);
+
+            if (Mhi) *Mhi = p11 + (p01 >> half_bits) + (p10 >> half_bits) + (mid >> half_bits);
+            if (Mlo) *Mlo = (mid << half_bits) | (p00 & half_mask);
+        }
+
+        inline void cpu_uadd128_64(uint64_t Ahi, uint64_t Alo, uint64_t Bhi, uint64_t Blo, uint64_t& Rhi, uint64_t& Rlo)
+        {
+            uint64_t lo = Alo + Blo;
+            Rhi = Ahi + Bhi + uint64_t(lo < Alo);
+            Rlo = lo;
+        }
+
+        inline void cpu_usub128_64(uint64_t Ahi, uint64_t Alo, uint64_t Bhi, uint64_t Blo, uint64_t& Rhi, uint64_t& Rlo)
+        {
+            uint64_t lo = Alo - Blo;
+            Rhi = Ahi - Bhi - uint64_t(Alo < Blo);
+            Rlo = lo;
+        }
+
+    }; // namespace platform_portable
+
+    // 128-64 operations, by compiler intrinsics on x64 platforms, and portable on others
+    // (the name is kept for compatibility, the functions are always defined)
+    namespace platform_AMD_x64
+    {
 
     // Divides 128-bit unsigned integer by 64-bit unsigned integer, assuming the quotent fits 64-bit (!)
     // Returns remainder in R, quotent in the name
@@ -45,10 +118,17 @@ namespace priv
 #if defined(SKLIB_INTERNAL_PLATFORM_MSVC_X64)
         return _udiv128(Ahi, Alo, B, R);
 #elif defined(SKLIB_INTERNAL_PLATFORM_GCC_X64)
-        static_assert(false, "Not implemented yet");
+        // DIV computes both quotent and remainder; division of unsigned __int128 would call library function instead
+        uint64_t Q, Rem;
+        __asm__("divq %4" : "=a"(Q), "=d"(Rem) : "a"(Alo), "d"(Ahi), "rm"(B) : "cc");
+        if (R) *R = Rem;
+        return Q;
+#elif defined(SKLIB_INTERNAL_PLATFORM_GCC_INT128)
+        unsigned __int128 A = ((unsigned __int128)Ahi << 64) | Alo;
+        if (R) *R = uint64_t(A % B);
+        return uint64_t(A / B);
 #else
-        if (R) *R = 0;
-        return 0;
+        return sklib::priv::platform_portable::cpu_udiv128_64(Ahi, Alo, B, R);
 #endif
     }
 
@@ -58,11 +138,12 @@ namespace priv
 #if defined(SKLIB_INTERNAL_PLATFORM_MSVC_X64)
         auto lo = _umul128(A, B, Mhi);
         if (Mlo) *Mlo = lo;
-#elif defined(SKLIB_INTERNAL_PLATFORM_GCC_X64)
-        static_assert(false, "Not implemented yet");
+#elif defined(SKLIB_INTERNAL_PLATFORM_GCC_INT128)
+        unsigned __int128 M = (unsigned __int128)A * B;
+        if (Mhi) *Mhi = uint64_t(M >> 64);
+        if (Mlo) *Mlo = uint64_t(M);
 #else
-        if (Mhi) *Mhi = 0;
-        if (Mlo) *Mlo = 0;
+        sklib::priv::platform_portable::cpu_umul128_64(A, B, Mhi, Mlo);
 #endif
     }
 
@@ -72,11 +153,13 @@ namespace priv
 #if defined(SKLIB_INTERNAL_PLATFORM_MSVC_X64)
         char c = _addcarry_u64(0, Alo, Blo, &Rlo);
         _addcarry_u64(c, Ahi, Bhi, &Rhi);
-#elif defined(SKLIB_INTERNAL_PLATFORM_GCC_X64)
-        static_assert(false, "Not implemented yet");
+#elif defined(__GNUC__)
+        uint64_t lo;
+        bool c = __builtin_add_overflow(Alo, Blo, &lo);
+        Rhi = Ahi + Bhi + uint64_t(c);
+        Rlo = lo;
 #else
-        Rhi = 0;
-        Rlo = 0;
+        sklib::priv::platform_portable::cpu_uadd128_64(Ahi, Alo, Bhi, Blo, Rhi, Rlo);
 #endif
     }
 
@@ -86,35 +169,25 @@ namespace priv
 #if defined(SKLIB_INTERNAL_PLATFORM_MSVC_X64)
         char c = _subborrow_u64(0, Alo, Blo, &Rlo);
         _subborrow_u64(c, Ahi, Bhi, &Rhi);
-#elif defined(SKLIB_INTERNAL_PLATFORM_GCC_X64)
-        static_assert(false, "Not implemented yet");
+#elif defined(__GNUC__)
+        uint64_t lo;
+        bool c = __builtin_sub_overflow(Alo, Blo, &lo);
+        Rhi = Ahi - Bhi - uint64_t(c);
+        Rlo = lo;
 #else
-        Rhi = 0;
-        Rlo = 0;
+        sklib::priv::platform_portable::cpu_usub128_64(Ahi, Alo, Bhi, Blo, Rhi, Rlo);
 #endif
     }
 
-#else // not SKLIB_INTERNAL_PLATFORM_KNOWN_X64
-
-    // AMDx64-specific functions are always declared so compilation always succeed
-    // Linker will succeed only the target is AMDx64
-    // Any program that doesn't use these symbols will compile for any platform;
-    // Anything that uses them requires x64 to compile
-    uint64_t cpu_udiv128_64(uint64_t Ahi, uint64_t Alo, uint64_t B, uint64_t* R);
-    void cpu_umul128_64(uint64_t A, uint64_t B, uint64_t* Mhi, uint64_t* Mlo);
-    void cpu_uadd128_64(uint64_t Ahi, uint64_t Alo, uint64_t Bhi, uint64_t Blo, uint64_t& Rhi, uint64_t& Rlo);
-    void cpu_usub128_64(uint64_t Ahi, uint64_t Alo, uint64_t Bhi, uint64_t Blo, uint64_t& Rhi, uint64_t& Rlo);
-
-#endif // SKLIB_INTERNAL_PLATFORM_KNOWN_X64
-
     }; // namespace platform_AMD_x64
 
     // Divides 128-bit unsigned integer by 64-bit unsigned integer, quotent may exceed 64 bit
-    // Returns remainder in R, quotent in Qhi, Qlo
+    // Returns remainder in R and in the name, quotent in Qhi, Qlo
     inline uint64_t udiv128_64(uint64_t Ahi, uint64_t Alo, uint64_t B, uint64_t& Qhi, uint64_t& Qlo, uint64_t& R)
     {
         Qhi = uidivrem(Ahi, B, &Ahi);
         Qlo = sklib::priv::platform_AMD_x64::cpu_udiv128_64(Ahi, Alo, B, &R);
+        return R;
     }
 
     // "Extended" uint limited support
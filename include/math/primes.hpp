@@ -13,5 +13,14 @@
 
 #include "primes/enumeration.hpp"
 #include "primes/eratosphenes.hpp"
+#include "primes/miller-rabin.hpp"
+#include "primes/sieve.hpp"
+#include "primes/sieve-parallel.hpp"
+#include "primes/wheel.hpp"
+#include "primes/prime-count.hpp"
+#include "primes/factorize.hpp"
 #include "primes/pcompressor.hpp"
+#include "primes/parchive.hpp"
+#include "primes/parchive-parallel.hpp"
+#include "primes/ptable.hpp"
 
@@ -16,6 +16,25 @@ enum class eratosphenes_status_type
     prime=0, composite, error
 };
 
+namespace priv
+{
+    // trial division by prime candidates after the last tested prime (or from 5 if none), see eratosphenes()
+    SKLIB_TEMPLATE_IF_UINT(T)
+    inline eratosphenes_status_type eratosphenes_margin(T value, uint32_t prime)
+    {
+        T Idx1 = (prime ? sklib::prime_candidate_to_index<T>(prime)+1 : 0);
+
+        for (int k=0; k<128; k++, Idx1++)
+        {
+            T p = sklib::prime_candidate<T>(Idx1);
+            if (value % p == 0) return eratosphenes_status_type::composite;
+            if (value / p <= p) return eratosphenes_status_type::prime;
+        }
+
+        return eratosphenes_status_type::error;
+    }
+};
+
 // Given the Primes is the list of all prime numbers starting with 2 and up to some maximum = max(Primes),
 // and the input value is a prime candidate, verify whether it is divisible to any available prime number.
 // The integer type in template argument defines the bit size of the prime candidate being considered.
@@ -61,27 +80,242 @@ inline eratosphenes_status_type eratosphenes(T Idx, const std::vector<uint32_t>&
     // 64-bit primes, and for testing small numbers for primality without maintaining
     // the list of primes at all. (All way up to and including the prime 116683 -
     // so all 17-bit primes can be searched without reference array.)
-    if (forgive_margin)
+    if (forgive_margin) return sklib::priv::eratosphenes_margin<T>(value, prime);
+
+    // not enough test primes and/or candidates to determine primality of the input
+    return eratosphenes_status_type::error;
+}
+
+SKLIB_TEMPLATE_IF_UINT(T)
+inline eratosphenes_status_type eratosphenes_general(T value, const std::vector<uint32_t>& Primes, bool forgive_margin = false)
+{
+    if (value % 2 == 0 || value % 3 == 0) return eratosphenes_status_type::composite;
+    return eratosphenes(prime_candidate_to_index(value), Primes, forgive_margin);
+}
+
+// Table of the primes 5, 7, 11, ... for trial division without division. For odd p, take inverse = p^-1 mod 2^64 and
+// limit = floor((2^64-1)/p); multiplication by inverse maps the multiples of p onto 0 ... limit, one-to-one, so
+// n is divisible by p exactly when n*inverse mod 2^64 <= limit. Loop stops at p*p > n, the square is also kept.
+// Reference: T. Granlund, P. L. Montgomery, "Division by Invariant Integers using Multiplication", PLDI 1994, sec. 9.
+//
+class prime_divisor_table_type
+{
+public:
+    struct entry_type
     {
-        T Idx1 = (prime ? prime_candidate_to_index<T>(prime)+1 : 0);
+        uint64_t inverse;
+        uint64_t limit;
+        uint64_t square;
+    };
 
-        for (int k=0; k<128; k++, Idx1++)
+    prime_divisor_table_type() = default;
+
+    // takes the primes from the list that starts with 2, 3, 5, ... (same as for eratosphenes()), up to max_prime
+    explicit prime_divisor_table_type(const std::vector<uint32_t>& Primes, uint32_t max_prime = UINT32_MAX)
+    {
+        for (size_t k=2; k<Primes.size() && Primes[k] <= max_prime; k++)
         {
-            T p = prime_candidate<T>(Idx1);
-            if (value % p == 0) return eratosphenes_status_type::composite;
-            if (value / p <= p) return eratosphenes_status_type::prime;
+            uint64_t p = Primes[k];
+            uint64_t inverse = p;
+            for (unsigned bits=3; bits<sklib::bits_width_v<uint64_t>; bits*=2) inverse *= 2 - p * inverse;   // p*p = 1 mod 8
+
+            Table.push_back({ inverse, UINT64_MAX / p, p * p });
+            last = Primes[k];
         }
     }
 
-    // not enough test primes and/or candidates to determine primality of the input
-    return eratosphenes_status_type::error;
+    size_t size() const { return Table.size(); }
+    uint32_t last_prime() const { return last; }        // 0 if the table is empty
+
+    const entry_type* begin() const { return Table.data(); }
+    const entry_type* end() const { return Table.data() + Table.size(); }
+
+    static bool is_divisible(uint64_t value, const entry_type& D) { return (value * D.inverse <= D.limit); }
+
+private:
+    std::vector<entry_type> Table;
+    uint32_t last = 0;
+};
+
+namespace priv
+{
+    // trial division of the prime candidate by the table from entry "first", when the primes below are already tested;
+    // "tests" counts divisibility tests
+    SKLIB_TEMPLATE_IF_UINT(T)
+    inline eratosphenes_status_type eratosphenes_divisors(T value, const prime_divisor_table_type& Divisors, size_t first,
+                                                          bool forgive_margin, size_t& tests)
+    {
+        // the candidate is not divisible by the primes tested before, so it is prime below the square of the next one
+        for (auto D = Divisors.begin() + first; D < Divisors.end(); D++)
+        {
+            if (value < D->square) return eratosphenes_status_type::prime;
+            tests++;
+            if (prime_divisor_table_type::is_divisible(value, *D)) return eratosphenes_status_type::composite;
+        }
+
+        uint32_t prime = Divisors.last_prime();
+        if (prime && value / prime <= prime) return eratosphenes_status_type::prime;
+
+        if (forgive_margin) return sklib::priv::eratosphenes_margin<T>(value, prime);
+        return eratosphenes_status_type::error;
+    }
+};
+
+// Same as eratosphenes() above, with the table of divisors in place of the list of primes; gives the same results
+//
+SKLIB_TEMPLATE_IF_UINT(T)
+inline eratosphenes_status_type eratosphenes(T Idx, const prime_divisor_table_type& Divisors, bool forgive_margin = false)
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "Divisor table is defined for integers up to 64 bits");
+
+    if (Idx <= 6) return eratosphenes_status_type::prime;
+
+    size_t tests = 0;
+    return sklib::priv::eratosphenes_divisors<T>(prime_candidate<T>(Idx), Divisors, 0, forgive_margin, tests);
 }
 
 SKLIB_TEMPLATE_IF_UINT(T)
-inline eratosphenes_status_type eratosphenes_general(T value, const std::vector<uint32_t>& Primes, bool forgive_margin = false)
+inline eratosphenes_status_type eratosphenes_general(T value, const prime_divisor_table_type& Divisors, bool forgive_margin = false)
 {
     if (value % 2 == 0 || value % 3 == 0) return eratosphenes_status_type::composite;
-    return eratosphenes(prime_candidate_to_index(value), Primes, forgive_margin);
+    return eratosphenes(prime_candidate_to_index(value), Divisors, forgive_margin);
+}
+
+// Tests "count" numbers from input, writes results into output, same as eratosphenes_general() with the table, except
+// that any number is accepted: 0 and 1 are composite, 2 and 3 are prime. Returns statistics of the batch.
+// The first "screen" primes of the table are tested in stages of growing length. In every stage, the numbers
+// still in question go in groups of eratosphenes_batch_lanes, and every group is tested against all primes of the
+// stage by reciprocal multiplication (see prime_divisor_table_type) without branches and without early exit, so
+// the compiler can keep the group in registers or vector lanes. After the stage, composites and the numbers below
+// the square of the next prime are resolved, and the rest are compacted for the next stage. Numbers that pass
+// all stages continue trial division one by one by the next primes of the table, with early exit.
+//
+inline constexpr unsigned eratosphenes_batch_lanes = 8;
+
+struct eratosphenes_batch_stats_type
+{
+    size_t count = 0;               // numbers tested
+    size_t stages = 0;              // screening stages made
+    size_t screen_tests = 0;        // divisibility tests made in groups, including unused lanes
+    size_t screen_composite = 0;    // found composite by screening
+    size_t screen_prime = 0;        // found prime by screening, below the square of the next prime
+    size_t survivors = 0;           // passed to trial division one by one
+    size_t survivor_tests = 0;      // divisibility tests made for the survivors
+    size_t errors = 0;              // not enough primes in the table to decide
+};
+
+namespace priv
+{
+    inline constexpr size_t eratosphenes_batch_screen = 1 << 8;
+    inline constexpr size_t eratosphenes_batch_first_stage = 1 << 3;
+
+    // 3^-1 mod 2^64, and floor((2^64-1)/3), see prime_divisor_table_type
+    inline constexpr uint64_t eratosphenes_inverse_3 = 0xAAAAAAAAAAAAAAABull;
+    inline constexpr uint64_t eratosphenes_limit_3 = UINT64_MAX / 3;
+
+    // numbers not divisible by the first "tested" primes of the table (and by 2, 3) are prime below this bound,
+    // see eratosphenes_divisors()
+    inline uint64_t eratosphenes_batch_bound(const prime_divisor_table_type& Divisors, size_t tested)
+    {
+        if (tested < Divisors.size()) return Divisors.begin()[tested].square;
+        if (!Divisors.size()) return 25;
+        return uint64_t(Divisors.last_prime()) * (Divisors.last_prime() + 1);
+    }
+};
+
+inline eratosphenes_batch_stats_type eratosphenes_batch(const uint64_t* input, size_t count, eratosphenes_status_type* output,
+                                                        const prime_divisor_table_type& Divisors, bool forgive_margin = false,
+                                                        size_t screen = sklib::priv::eratosphenes_batch_screen)
+{
+    using namespace sklib::priv;
+    constexpr unsigned L = eratosphenes_batch_lanes;
+    static_assert(L <= sklib::bits_width_v<unsigned>, "Lanes are marked by bits of unsigned integer");
+
+    eratosphenes_batch_stats_type stats;
+    stats.count = count;
+
+    screen = alt_min(screen, Divisors.size());
+    const auto* D = Divisors.begin();
+
+    // divisors 2 and 3
+    std::vector<size_t> live;
+    uint64_t bound = eratosphenes_batch_bound(Divisors, 0);
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t x = input[i];
+        if (x < 4)
+        {
+            output[i] = (x < 2 ? eratosphenes_status_type::composite : eratosphenes_status_type::prime);
+            stats.screen_prime += (x >= 2);
+            stats.screen_composite += (x < 2);
+        }
+        else if (!(x & 1) || x * eratosphenes_inverse_3 <= eratosphenes_limit_3)
+        {
+            output[i] = eratosphenes_status_type::composite;
+            stats.screen_composite++;
+        }
+        else if (x < bound)
+        {
+            output[i] = eratosphenes_status_type::prime;
+            stats.screen_prime++;
+        }
+        else
+        {
+            live.push_back(i);
+        }
+    }
+
+    for (size_t first=0, length=eratosphenes_batch_first_stage; first<screen && !live.empty(); first+=length, length*=2)
+    {
+        size_t last = alt_min(screen, first + length);
+        bound = eratosphenes_batch_bound(Divisors, last);
+        stats.stages++;
+
+        size_t N = 0, M = live.size();
+        for (size_t g=0; g<M; g+=L)
+        {
+            uint64_t x[L];
+            unsigned hit = 0;       // one bit per lane
+            for (unsigned k=0; k<L; k++) x[k] = input[live[g + k < M ? g + k : g]];     // unused lanes repeat the first one
+
+            // the smallest multiple of p that is not divisible by smaller primes is p^2
+            for (size_t j=first; j<last; j++)
+            {
+                const uint64_t inverse = D[j].inverse, limit = D[j].limit, square = D[j].square;
+                for (unsigned k=0; k<L; k++) hit |= unsigned((x[k] * inverse <= limit) & (x[k] >= square)) << k;
+            }
+            stats.screen_tests += L * (last - first);
+
+            for (unsigned k=0; k<L && g+k<M; k++)
+            {
+                size_t i = live[g+k];
+                if ((hit >> k) & 1)
+                {
+                    output[i] = eratosphenes_status_type::composite;
+                    stats.screen_composite++;
+                }
+                else if (x[k] < bound)
+                {
+                    output[i] = eratosphenes_status_type::prime;
+                    stats.screen_prime++;
+                }
+                else
+                {
+                    live[N++] = i;      // never ahead of the group being read
+                }
+            }
+        }
+        live.resize(N);
+    }
+
+    stats.survivors = live.size();
+    for (auto i : live)
+    {
+        output[i] = eratosphenes_divisors<uint64_t>(input[i], Divisors, screen, forgive_margin, stats.survivor_tests);
+        if (output[i] == eratosphenes_status_type::error) stats.errors++;
+    }
+
+    return stats;
 }
 
 inline bool is_eratosphenes_status_error(eratosphenes_status_type code)
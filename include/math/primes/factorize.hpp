@@ -0,0 +1,182 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides factorization of 64-bit integers into primes
+// This is internal SKLib file and must NOT be included directly.
+
+// Small factors are removed by trial division with the list of primes (2, 3, 5, ... same as primes_decode()),
+// the remaining cofactor is split by Pollard's rho method in Brent's variant, until every part passes the
+// Miller-Rabin test (see miller-rabin.hpp). The sequence x -> x^2 + c is computed in Montgomery form; instead of
+// GCD on every step, differences are multiplied together and GCD is taken once per batch of steps.
+// Reference: R. P. Brent, "An improved Monte Carlo factorization algorithm", BIT 20 (1980), 176-184.
+
+struct prime_factor_type
+{
+    uint64_t prime = 0;
+    unsigned power = 0;
+};
+
+namespace priv
+{
+    // trial division is only efficient for small primes, then rho is faster
+    inline constexpr uint32_t factorize_trial_limit = 1 << 12;
+
+    // number of rho steps per GCD
+    inline constexpr unsigned factorize_gcd_batch = 128;
+
+    inline const std::vector<uint32_t>& factorize_default_primes()
+    {
+        static const std::vector<uint32_t> R = []()
+        {
+            std::vector<uint32_t> P;
+            sklib::primes_sieve(factorize_trial_limit, P);
+            return P;
+        }();
+        return R;
+    }
+
+    // finds a nontrivial divisor of odd composite n
+    inline uint64_t factorize_brent(uint64_t n)
+    {
+        sklib::montgomery_context_type<uint64_t> M(n);
+
+        for (uint64_t c0=1; ; c0++)
+        {
+            uint64_t c = M.to(c0);
+            auto f = [&M, c](uint64_t v) { return M.add(M.mul(v, v), c); };
+
+            uint64_t y = M.to(2);
+            uint64_t x = y, ys = y;
+            uint64_t q = M.one();
+            uint64_t g = 1;
+
+            for (uint64_t r=1; g == 1; r *= 2)
+            {
+                x = y;
+                for (uint64_t i=0; i<r; i++) y = f(y);
+
+                for (uint64_t k=0; k<r && g == 1; k += factorize_gcd_batch)
+                {
+                    ys = y;
+                    uint64_t steps = alt_min<uint64_t>(factorize_gcd_batch, r - k);
+                    for (uint64_t i=0; i<steps; i++)
+                    {
+                        y = f(y);
+                        q = M.mul(q, M.sub(x, y));
+                    }
+                    g = sklib::gcd(q, n);    // q is in Montgomery form, but q*R has the same common divisors with n
+                }
+            }
+
+            // the batch collected all factors at once, step back to the first one
+            if (g == n)
+            {
+                do
+                {
+                    ys = f(ys);
+                    g = sklib::gcd(M.sub(x, ys), n);
+                }
+                while (g == 1);
+            }
+
+            if (g != n) return g;
+        }
+    }
+
+    // n is odd
+    inline void factorize_split(uint64_t n, std::vector<prime_factor_type>& Factors)
+    {
+        if (n == 1) return;
+        if (sklib::miller_rabin(n))
+        {
+            Factors.push_back({ n, 1 });
+            return;
+        }
+
+        uint64_t d = factorize_brent(n);
+        factorize_split(d, Factors);
+        factorize_split(n / d, Factors);
+    }
+};
+
+// Clears the output array, and fills it with prime factors of n with their multiplicities, in ascending order.
+// Primes is the list of consecutive primes starting from 2, used for trial division (up to factorize_trial_limit).
+// Returns false if n is 0.
+//
+inline bool factorize(uint64_t n, std::vector<prime_factor_type>& Factors, const std::vector<uint32_t>& Primes)
+{
+    Factors.clear();
+    if (!n) return false;
+
+    // factor 2 is always removed here: Montgomery form used by rho requires odd modulus
+    if (!(n & 1))
+    {
+        prime_factor_type F = { 2, 0 };
+        for (; !(n & 1); n >>= 1) F.power++;
+        Factors.push_back(F);
+    }
+
+    bool all_tried = false;     // true if trial division went past sqrt(n), so the rest is 1 or prime
+    for (auto p : Primes)
+    {
+        if (p > sklib::priv::factorize_trial_limit) break;
+        if (uint64_t(p) * p > n)
+        {
+            all_tried = true;
+            break;
+        }
+        if (p == 2 || n % p) continue;
+
+        prime_factor_type F = { p, 0 };
+        do
+        {
+            n /= p;
+            F.power++;
+        }
+        while (n % p == 0);
+        Factors.push_back(F);
+    }
+
+    if (n == 1) return true;
+    if (all_tried)
+    {
+        Factors.push_back({ n, 1 });
+        return true;
+    }
+
+    size_t small = Factors.size();
+    sklib::priv::factorize_split(n, Factors);
+
+    // sort the factors found by rho, and merge the same primes
+    for (size_t i=small+1; i<Factors.size(); i++)
+    {
+        auto F = Factors[i];
+        size_t j = i;
+        for (; j>small && Factors[j-1].prime > F.prime; j--) Factors[j] = Factors[j-1];
+        Factors[j] = F;
+    }
+
+    size_t N = small;
+    for (size_t i=small; i<Factors.size(); i++)
+    {
+        if (N > small && Factors[N-1].prime == Factors[i].prime) Factors[N-1].power += Factors[i].power;
+        else Factors[N++] = Factors[i];
+    }
+    Factors.resize(N);
+
+    return true;
+}
+
+// Same as above, with the built-in list of small primes
+//
+inline bool factorize(uint64_t n, std::vector<prime_factor_type>& Factors)
+{
+    return factorize(n, Factors, sklib::priv::factorize_default_primes());
+}
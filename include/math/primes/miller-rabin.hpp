@@ -0,0 +1,194 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides deterministic Miller-Rabin primality test for 64-bit integers
+// This is internal SKLib file and must NOT be included directly.
+
+// Unlike eratosphenes(), the test doesn't need the list of primes. For n < 2^64, the set of 7 bases found by
+// Jim Sinclair is known to have no strong pseudoprimes; for n < 2^32, bases 2, 7, 61 are enough.
+// Reference: https://miller-rabin.appspot.com/
+// Candidates are first screened by trial division by small primes, which rejects about 80% of odd numbers.
+// Modular exponentiation is done with Montgomery multiplication (see algebra/montgomery.hpp).
+
+namespace priv
+{
+    inline constexpr uint64_t miller_rabin_bases_32[3] = { 2, 7, 61 };
+    inline constexpr uint64_t miller_rabin_bases_64[7] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+    inline constexpr uint32_t miller_rabin_trial_primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61 };
+    inline constexpr uint64_t miller_rabin_trial_limit = 61 * 61;
+
+    enum class miller_rabin_screen_type { prime, composite, unknown };
+
+    // trial division by small primes; numbers below 61^2 are resolved completely
+    inline miller_rabin_screen_type miller_rabin_screen(uint64_t n)
+    {
+        if (n < 2) return miller_rabin_screen_type::composite;
+        for (auto p : miller_rabin_trial_primes)
+        {
+            if (n % p == 0) return (n == p ? miller_rabin_screen_type::prime : miller_rabin_screen_type::composite);
+        }
+        return (n < miller_rabin_trial_limit ? miller_rabin_screen_type::prime : miller_rabin_screen_type::unknown);
+    }
+
+    // true if n is strong probable prime to base a (Montgomery form); n-1 = d*2^s
+    inline bool miller_rabin_round(const sklib::montgomery_context_type<uint64_t>& M, uint64_t a, uint64_t d, unsigned s)
+    {
+        uint64_t x = sklib::modpow(M, a, d);
+        if (x == M.one() || x == M.minus_one()) return true;
+        for (unsigned k=1; k<s; k++)
+        {
+            x = M.mul(x, x);
+            if (x == M.minus_one()) return true;
+            if (x == M.one()) return false;
+        }
+        return false;
+    }
+
+    // odd n > 61^2
+    inline bool miller_rabin_core(uint64_t n)
+    {
+        sklib::montgomery_context_type<uint64_t> M(n);
+
+        uint64_t d = n - 1;
+        unsigned s = 0;
+        for (; !(d & 1); s++) d >>= 1;
+
+        auto test = [&](const auto& bases)
+        {
+            for (auto a : bases)
+            {
+                a %= n;
+                if (a && !miller_rabin_round(M, M.to(a), d, s)) return false;
+            }
+            return true;
+        };
+
+        return (n >> sklib::bits_width_v<uint32_t> ? test(miller_rabin_bases_64) : test(miller_rabin_bases_32));
+    }
+};
+
+// Deterministic primality test for any 64-bit number
+//
+inline bool miller_rabin(uint64_t n)
+{
+    auto screen = sklib::priv::miller_rabin_screen(n);
+    if (screen != sklib::priv::miller_rabin_screen_type::unknown) return (screen == sklib::priv::miller_rabin_screen_type::prime);
+    return sklib::priv::miller_rabin_core(n);
+}
+
+inline eratosphenes_status_type miller_rabin_status(uint64_t n)
+{
+    return (miller_rabin(n) ? eratosphenes_status_type::prime : eratosphenes_status_type::composite);
+}
+
+// Tests "count" numbers from input, writes results into output (true for primes).
+// Candidates that pass trial division are tested one base at a time for the whole batch, and composites
+// are dropped after every round. Within a round, candidates are processed in groups of miller_rabin_batch_lanes,
+// with every Montgomery multiplication step interleaved across the group: independent multiplications
+// fill the CPU pipeline, while a single test waits for the result of every multiplication.
+//
+inline constexpr unsigned miller_rabin_batch_lanes = 4;
+
+namespace priv
+{
+    struct miller_rabin_lane_type
+    {
+        size_t index;
+        sklib::montgomery_context_type<uint64_t> M;
+        uint64_t d;
+        unsigned s;
+        const uint64_t* bases;
+        unsigned base_count;
+    };
+
+    // one round of the test for a group of lanes, lane[k] may repeat; passed[k] receives the result
+    inline void miller_rabin_round_interleaved(miller_rabin_lane_type* const* lane, unsigned round, bool* passed)
+    {
+        constexpr unsigned L = sklib::miller_rabin_batch_lanes;
+        sklib::montgomery_context_type<uint64_t> M[L];   // local copies, so the compiler can keep all lanes in registers
+        uint64_t d[L], x[L];
+        uint64_t base[L];                               // Montgomery form
+        unsigned s[L];
+        bool done[L];
+        unsigned max_s = 0;
+
+        for (unsigned k=0; k<L; k++)
+        {
+            M[k] = lane[k]->M;
+            d[k] = lane[k]->d;
+            s[k] = lane[k]->s;
+            uint64_t b = lane[k]->bases[round] % M[k].modulus();
+            done[k] = !b;
+            base[k] = M[k].to(b);
+            max_s = alt_max(max_s, s[k]);
+        }
+
+        // exponentiation by fixed windows, all lanes in step, no branches
+        sklib::modpow_interleaved<L>(M, base, d, x);
+
+        for (unsigned k=0; k<L; k++) if (x[k] == M[k].one() || x[k] == M[k].minus_one()) done[k] = true;
+
+        for (unsigned r=1; r<max_s; r++)
+        {
+            for (unsigned k=0; k<L; k++)
+            {
+                if (done[k] || r >= s[k]) continue;
+                x[k] = M[k].mul(x[k], x[k]);
+                if (x[k] == M[k].minus_one()) done[k] = true;
+            }
+        }
+
+        for (unsigned k=0; k<L; k++) passed[k] = done[k];
+    }
+};
+
+inline void miller_rabin_batch(const uint64_t* input, size_t count, bool* output)
+{
+    using namespace sklib::priv;
+    constexpr unsigned L = miller_rabin_batch_lanes;
+
+    std::vector<miller_rabin_lane_type> queue;
+
+    for (size_t i=0; i<count; i++)
+    {
+        uint64_t n = input[i];
+        auto screen = miller_rabin_screen(n);
+        output[i] = (screen != miller_rabin_screen_type::composite);
+        if (screen != miller_rabin_screen_type::unknown) continue;
+
+        miller_rabin_lane_type C{ i, sklib::montgomery_context_type<uint64_t>(n), n - 1, 0, miller_rabin_bases_64, unsigned(std::size(miller_rabin_bases_64)) };
+        for (; !(C.d & 1); C.s++) C.d >>= 1;
+        if (!(n >> sklib::bits_width_v<uint32_t>))
+        {
+            C.bases = miller_rabin_bases_32;
+            C.base_count = unsigned(std::size(miller_rabin_bases_32));
+        }
+        queue.push_back(C);
+    }
+
+    for (unsigned round=0; !queue.empty(); round++)
+    {
+        // candidates that passed all their bases are primes, composites are already marked in output
+        size_t N = 0;
+        for (auto& C : queue) if (output[C.index] && round < C.base_count) queue[N++] = C;
+        queue.resize(N);
+
+        for (size_t g=0; g<N; g+=L)
+        {
+            miller_rabin_lane_type* lane[L];
+            bool passed[L];
+            for (unsigned k=0; k<L; k++) lane[k] = &queue[g + k < N ? g + k : g];   // unused lanes repeat the first one
+
+            miller_rabin_round_interleaved(lane, round, passed);
+            for (unsigned k=0; k<L && g+k<N; k++) if (!passed[k]) output[queue[g+k].index] = false;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides multi-threaded decoding of the block-indexed primes archive (see parchive.hpp)
+// This is internal SKLib file and must NOT be included directly.
+
+// The blocks are read from the file at once, then split between threads in consecutive ranges. The place of every
+// block in the output is known from its index, so threads write directly into the preallocated array.
+// CRC of the whole array is combined from CRCs of the blocks: appending n zero octets to CRC-32 input is a linear
+// operator on the CRC state, so crc(A|B) = Z(crc(A)) ^ crc(B), where Z appends as many zeros as B has octets.
+// Reference: zlib, crc32_combine().
+
+namespace priv
+{
+    // operator Z for crc_32_iso, as 32x32 bit matrix over GF(2), one column per uint32_t
+    class primes_crc32_shift_type
+    {
+    public:
+        explicit primes_crc32_shift_type(uint64_t octets)
+        {
+            uint32_t op[width];     // one zero bit: bit 0 goes out with the polynomial, other bits shift down
+            op[0] = sklib::crc_32_iso::Polynomial;
+            for (unsigned n=1; n<width; n++) op[n] = uint32_t(1) << (n - 1);
+            for (unsigned n=0; n<width; n++) M[n] = uint32_t(1) << n;
+
+            for (uint64_t bits = octets * sklib::OCTET_BITS; bits; bits >>= 1)
+            {
+                if (bits & 1) for (auto& column : M) column = times(op, column);
+
+                uint32_t square[width];
+                for (unsigned n=0; n<width; n++) square[n] = times(op, op[n]);
+                for (unsigned n=0; n<width; n++) op[n] = square[n];
+            }
+        }
+
+        // CRC of A|B from crc(A) and crc(B), if the operator was made for the length of B
+        uint32_t combine(uint32_t crc_first, uint32_t crc_second) const { return times(M, crc_first) ^ crc_second; }
+
+    private:
+        static constexpr unsigned width = sklib::bits_width_v<uint32_t>;
+        uint32_t M[width];
+
+        static uint32_t times(const uint32_t* matrix, uint32_t v)
+        {
+            uint32_t R = 0;
+            for (unsigned n=0; v; n++, v >>= 1) if (v & 1) R ^= matrix[n];
+            return R;
+        }
+    };
+};
+
+// Same as primes_decode(), for the block-indexed archive; the archive starts at the current position in the file.
+// Clears the output array, and fills it by multiple threads. CRC of every block is verified, and the CRCs are
+// combined into the CRC of the whole array, which is compared with the one stored in the archive.
+// Every 1 second and immediately before successful exit calls heartbeat if not nullptr, with payload and
+// the number of records decoded by all threads together; heartbeat may be called from any of the threads,
+// but never concurrently. threads=0 means all available CPU cores.
+// Returned CRC reflects the actual content of PrimesArrayOutput.
+//
+inline primes_decoder_status_type primes_decode_parallel(sklib::bits_file_type& fPackedInput,
+                                                         std::vector<uint32_t>& PrimesArrayOutput,
+                                                         uint32_t& CurrentCRC,
+                                                         void (*heartbeat)(void*, uint32_t) = nullptr,
+                                                         void* payload = nullptr,
+                                                         unsigned threads = 0)
+{
+    PrimesArrayOutput.clear();
+
+    primes_archive_type Archive;
+    auto status = Archive.open(fPackedInput);
+    if (status != primes_decoder_status_type::OK) return status;
+
+    size_t N = Archive.block_count();
+    std::vector<uint8_t> image;
+    if (!Archive.read_image(0, N, image)) return primes_decoder_status_type::broken_archive;
+
+    PrimesArrayOutput.resize(Archive.size());
+    std::vector<uint32_t> block_crc(N, 0);
+    std::vector<primes_decoder_status_type> block_status(N, primes_decoder_status_type::OK);
+
+    std::atomic<uint32_t> nrecords = 0;
+    std::atomic<bool> strobe_busy = false;
+    sklib::timer_stopwatch_type strobe(1000);
+
+    sklib::aux::parallel_split_type(N, 1, 1, threads).run([&](unsigned, size_t begin, size_t end)
+    {
+        for (size_t k=begin; k<end; k++)
+        {
+            uint64_t from = Archive.block_offset(k) - Archive.block_offset(0);
+            uint64_t length = Archive.block_offset(k+1) - Archive.block_offset(k);
+            uint32_t first = Archive.block_first_index(k);
+
+            block_status[k] = sklib::priv::primes_archive_decode_block(image.data() + from, size_t(length), first, Archive.block_size(k),
+                                                                       PrimesArrayOutput.data() + first, block_crc[k]);
+
+            // with CRC mismatch, the block is still decoded
+            if (block_status[k] != primes_decoder_status_type::OK && block_status[k] != primes_decoder_status_type::CRC_mismatch) break;
+
+            uint32_t done = (nrecords += Archive.block_size(k));
+            if (heartbeat && !strobe_busy.exchange(true))
+            {
+                if (strobe(true)) heartbeat(payload, done);
+                strobe_busy = false;
+            }
+        }
+    });
+
+    bool mismatch = false;
+    for (auto S : block_status)
+    {
+        if (S == primes_decoder_status_type::CRC_mismatch) mismatch = true;
+        else if (S != primes_decoder_status_type::OK) return S;
+    }
+
+    // all blocks but the last one have the same length
+    uint32_t R = 0;
+    sklib::priv::primes_crc32_shift_type shift(uint64_t(Archive.block_length()) * sizeof(uint32_t));
+    for (size_t k=0; k<N; k++)
+    {
+        if (Archive.block_size(k) == Archive.block_length()) R = shift.combine(R, block_crc[k]);
+        else R = sklib::priv::primes_crc32_shift_type(uint64_t(Archive.block_size(k)) * sizeof(uint32_t)).combine(R, block_crc[k]);
+    }
+
+    CurrentCRC = R;
+    if (mismatch || CurrentCRC != Archive.CRC()) return primes_decoder_status_type::CRC_mismatch;
+
+    if (heartbeat) heartbeat(payload, Archive.size());
+
+    return primes_decoder_status_type::OK;
+}
@@ -0,0 +1,400 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides block-indexed primes archive (version 2), with random access to the primes
+// This is internal SKLib file and must NOT be included directly.
+
+// The list of primes 2, 3, 5, ... is split into blocks of equal number of primes (the last block may be shorter).
+// Every block is octet-aligned and decodable on its own: it starts with the first prime, its index in the list,
+// and CRC of the block, followed by the delta codes of primes_decode() format (see pcompressor.hpp) without
+// the end marker. Block CRC is computed the same way as the CRC of primes_decode(), over the primes of the block.
+// All numbers are written MSB first, the same as bits_stream_base_type does. Layout of the archive:
+//
+//   magic "SKP2" (32 bits), block length (32), number of primes (32), CRC of all primes (32), number of blocks (32)
+//   table: for every block, offset from the start of archive (64) and the first prime (32); then end of archive (64)
+//   CRC of the header and table (32)
+//   blocks: first prime (32), index of the first prime (32), block CRC (32), delta codes, padding to octet
+//
+// Any prime by index, or the primes of a range, are found by decoding only the blocks that hold them.
+
+namespace priv
+{
+    inline constexpr uint32_t primes_archive_magic = 0x534B5032;
+    inline constexpr uint32_t primes_archive_default_block = 1 << 12;
+
+    inline constexpr size_t primes_archive_header_octets = 5 * sizeof(uint32_t);
+    inline constexpr size_t primes_archive_entry_octets = sizeof(uint64_t) + sizeof(uint32_t);
+    inline constexpr size_t primes_archive_block_header_octets = 3 * sizeof(uint32_t);
+
+    // bit stream over octets in memory: reads from the given buffer, or appends to the vector
+    class primes_archive_memory_type : public sklib::bits_stream_base_type
+    {
+    public:
+        explicit primes_archive_memory_type(std::vector<uint8_t>& output)
+            : sklib::bits_stream_base_type(read_octet_proc, write_octet_proc)
+            , out(&output)
+        {}
+
+        primes_archive_memory_type(const uint8_t* input, size_t length)
+            : sklib::bits_stream_base_type(read_octet_proc, write_octet_proc)
+            , in(input)
+            , in_end(input + length)
+        {}
+
+        uint32_t read32()
+        {
+            auto R = sklib::bits_pack<sklib::bits_width_v<uint32_t>, uint32_t>(0);
+            read(R);
+            return R.data;
+        }
+
+        uint64_t read64()
+        {
+            auto R = sklib::bits_pack<sklib::bits_width_v<uint64_t>, uint64_t>(0);
+            read(R);
+            return R.data;
+        }
+
+        void write32(uint32_t v) { write(sklib::bits_pack<sklib::bits_width_v<uint32_t>, uint32_t>(v)); }
+        void write64(uint64_t v) { write(sklib::bits_pack<sklib::bits_width_v<uint64_t>, uint64_t>(v)); }
+
+    private:
+        const uint8_t* in = nullptr;
+        const uint8_t* in_end = nullptr;
+        std::vector<uint8_t>* out = nullptr;
+
+        static bool read_octet_proc(sklib::bits_stream_base_type* root, uint8_t& data)
+        {
+            auto self = static_cast<primes_archive_memory_type*>(root);
+            if (self->in == self->in_end) return false;
+            data = *self->in++;
+            return true;
+        }
+
+        static void write_octet_proc(sklib::bits_stream_base_type* root, uint8_t data)
+        {
+            auto self = static_cast<primes_archive_memory_type*>(root);
+            if (self->out) self->out->push_back(data);
+        }
+    };
+
+    // decodes the block from its octets into Output[0] ... Output[count-1]
+    inline primes_decoder_status_type primes_archive_decode_block(const uint8_t* image, size_t image_length,
+                                                                  uint32_t first_index, uint32_t count,
+                                                                  uint32_t* Output, uint32_t& BlockCRC)
+    {
+        if (image_length < primes_archive_block_header_octets) return primes_decoder_status_type::broken_archive;
+
+        bool given = false;
+        auto source = [&](const uint8_t*& begin, const uint8_t*& end)
+        {
+            if (given) return false;
+            given = true;
+            begin = image;
+            end = image + image_length;
+            return true;
+        };
+        primes_compressor_reader_type<decltype(source)> reader(source);
+
+        constexpr unsigned W = sklib::bits_width_v<uint32_t>;
+        auto read32 = [&reader]() { uint32_t v = reader.peek(W); reader.skip(W); return v; };
+
+        uint32_t P = read32();
+        if (read32() != first_index || !count) return primes_decoder_status_type::broken_archive;
+        uint32_t StoredCRC = read32();
+
+        primes_compressor_crc_type Checksum;
+        uint32_t k = 0;
+        Output[k++] = P;
+        Checksum.update(P);
+
+        // 2 and 3 are not prime candidates, and have no codes after them
+        while (P < 5 && k < count)
+        {
+            P = (P == 2 ? 3 : 5);
+            Output[k++] = P;
+            Checksum.update(P);
+        }
+
+        if (k < count)
+        {
+            bool end_marker = false;
+            auto status = primes_compressor_decode_run(reader, sklib::prime_candidate_to_index<uint32_t>(P), count - k, end_marker, [&](uint32_t Q)
+            {
+                Output[k++] = Q;
+                Checksum.update(Q);
+            });
+            if (status != primes_decoder_status_type::OK) return status;
+            if (end_marker) return primes_decoder_status_type::broken_archive;
+        }
+
+        BlockCRC = Checksum.get();
+        return (BlockCRC == StoredCRC ? primes_decoder_status_type::OK : primes_decoder_status_type::CRC_mismatch);
+    }
+};
+
+// Writes block-indexed archive of the primes, starting from the current position in the file (octet boundary).
+// Primes must be consecutive prime numbers starting from 2, the same layout as of primes_decode() output;
+// the sequence is checked by primes_compressor_check() (ascending numbers 6n+-1 with the gaps that fit the delta code),
+// but not tested for primality.
+// block_length is the number of primes in every block. The file is not written if the input is rejected.
+//
+inline primes_encoder_status_type primes_archive_encode(sklib::bits_file_type& fPackedOutput,
+                                                        const std::vector<uint32_t>& Primes,
+                                                        uint32_t block_length = sklib::priv::primes_archive_default_block)
+{
+    using namespace sklib::priv;
+
+    if (!block_length) block_length = primes_archive_default_block;
+
+    for (size_t k=0; k<Primes.size(); k++)
+    {
+        uint32_t delta = 0;
+        auto status = primes_compressor_check(k, Primes[k], (k ? Primes[k-1] : 0), delta);
+        if (status != primes_encoder_status_type::OK) return status;
+    }
+
+    uint32_t count = uint32_t(Primes.size());
+    size_t block_count = (size_t(count) + block_length - 1) / block_length;
+
+    std::vector<uint8_t> blocks;
+    std::vector<uint64_t> offsets;
+    primes_compressor_crc_type Checksum;
+
+    for (size_t b=0; b<block_count; b++)
+    {
+        uint32_t first = uint32_t(b * block_length);
+        uint32_t last = alt_min(count, uint32_t(first + block_length));
+        offsets.push_back(blocks.size());
+
+        primes_compressor_crc_type BlockChecksum;
+        for (uint32_t k=first; k<last; k++)
+        {
+            BlockChecksum.update(Primes[k]);
+            Checksum.update(Primes[k]);
+        }
+
+        primes_archive_memory_type fBlock(blocks);
+        fBlock.write32(Primes[first]);
+        fBlock.write32(first);
+        fBlock.write32(BlockChecksum.get());
+
+        for (uint32_t k=first+1; k<last; k++)
+        {
+            if (Primes[k-1] < 5) continue;
+            primes_compressor_write_delta(fBlock, int(sklib::prime_candidate_to_index<uint32_t>(Primes[k]) - sklib::prime_candidate_to_index<uint32_t>(Primes[k-1])));
+        }
+
+        fBlock.write_flush();
+    }
+
+    std::vector<uint8_t> header;
+    primes_archive_memory_type fHeader(header);
+    fHeader.write32(primes_archive_magic);
+    fHeader.write32(block_length);
+    fHeader.write32(count);
+    fHeader.write32(Checksum.get());
+    fHeader.write32(uint32_t(block_count));
+
+    uint64_t start = primes_archive_header_octets + block_count * primes_archive_entry_octets + sizeof(uint64_t) + sizeof(uint32_t);
+    for (size_t b=0; b<block_count; b++)
+    {
+        fHeader.write64(start + offsets[b]);
+        fHeader.write32(Primes[b * block_length]);
+    }
+    fHeader.write64(start + blocks.size());
+
+    fHeader.write32(sklib::crc_32_iso().update(header.data(), header.size()));
+
+    fPackedOutput.write_flush();
+    auto& fs = fPackedOutput.file_stream();
+    fs.write(reinterpret_cast<const char*>(header.data()), std::streamsize(header.size()));
+    fs.write(reinterpret_cast<const char*>(blocks.data()), std::streamsize(blocks.size()));
+    fs.flush();
+
+    return primes_encoder_status_type::OK;
+}
+
+// Reader of the block-indexed archive. open() reads the header and the table of blocks, starting from the current
+// position in the file (octet boundary); then the blocks are read from the file on request.
+// The file must stay open while the object is in use.
+//
+class primes_archive_type
+{
+public:
+    primes_archive_type() = default;
+    explicit primes_archive_type(sklib::bits_file_type& fPackedInput) { open(fPackedInput); }
+
+    primes_decoder_status_type open(sklib::bits_file_type& fPackedInput)
+    {
+        using namespace sklib::priv;
+
+        file = nullptr;
+        blocks.clear();
+        cached_block = no_block;
+
+        auto& fs = fPackedInput.file_stream();
+        base = fs.tellg();
+
+        std::vector<uint8_t> header(primes_archive_header_octets);
+        if (!read_octets(fs, base, header.data(), header.size())) return primes_decoder_status_type::broken_archive;
+
+        primes_archive_memory_type fHeader(header.data(), header.size());
+        if (fHeader.read32() != primes_archive_magic) return primes_decoder_status_type::wrong_format;
+        length = fHeader.read32();
+        count = fHeader.read32();
+        crc = fHeader.read32();
+        size_t block_count = fHeader.read32();
+        if (!length || block_count != (size_t(count) + length - 1) / length) return primes_decoder_status_type::wrong_format;
+
+        // table, end of archive, and CRC of all the above
+        header.resize(primes_archive_header_octets + block_count * primes_archive_entry_octets + sizeof(uint64_t) + sizeof(uint32_t));
+        if (!read_octets(fs, base + std::streamoff(primes_archive_header_octets),
+                         header.data() + primes_archive_header_octets, header.size() - primes_archive_header_octets))
+        {
+            return primes_decoder_status_type::broken_archive;
+        }
+
+        primes_archive_memory_type fTable(header.data() + primes_archive_header_octets, header.size() - primes_archive_header_octets);
+        blocks.resize(block_count + 1);
+        for (auto& B : blocks)
+        {
+            B.offset = fTable.read64();
+            if (&B != &blocks.back()) B.first_prime = fTable.read32();
+        }
+
+        size_t checked = header.size() - sizeof(uint32_t);
+        if (fTable.read32() != sklib::crc_32_iso().update(header.data(), checked))
+        {
+            blocks.clear();
+            return primes_decoder_status_type::CRC_mismatch;
+        }
+
+        file = &fPackedInput;
+        return primes_decoder_status_type::OK;
+    }
+
+    bool is_open() const { return (file != nullptr); }
+
+    uint32_t size() const { return count; }                 // number of primes in the archive
+    uint32_t block_length() const { return length; }
+    size_t block_count() const { return (blocks.empty() ? 0 : blocks.size() - 1); }
+    uint32_t CRC() const { return crc; }                    // same as CRC from primes_decode() for the same primes
+
+    uint32_t block_first_index(size_t k) const { return uint32_t(k * length); }
+    uint32_t block_size(size_t k) const { return sklib::priv::alt_min(length, uint32_t(count - k * length)); }
+    uint32_t block_first_prime(size_t k) const { return blocks[k].first_prime; }
+    uint64_t block_offset(size_t k) const { return blocks[k].offset; }  // k = block_count() is the end of archive
+
+    // reads octets of blocks from first to last-1 as they are in the file
+    bool read_image(size_t first, size_t last, std::vector<uint8_t>& image) const
+    {
+        if (!is_open() || first > last || last > block_count() || blocks[last].offset < blocks[first].offset) return false;
+        image.resize(size_t(blocks[last].offset - blocks[first].offset));
+        return read_octets(file->file_stream(), base + std::streamoff(blocks[first].offset), image.data(), image.size());
+    }
+
+    // clears the output array, and fills it with primes of block k
+    primes_decoder_status_type read_block(size_t k, std::vector<uint32_t>& PrimesArrayOutput, uint32_t* BlockCRC = nullptr)
+    {
+        PrimesArrayOutput.clear();
+        if (!is_open()) return primes_decoder_status_type::wrong_format;
+        if (k >= block_count()) return primes_decoder_status_type::out_of_range;
+
+        std::vector<uint8_t> image;
+        if (!read_image(k, k+1, image)) return primes_decoder_status_type::broken_archive;
+
+        uint32_t CurrentCRC = 0;
+        PrimesArrayOutput.resize(block_size(k));
+        auto status = sklib::priv::primes_archive_decode_block(image.data(), image.size(), block_first_index(k), block_size(k),
+                                                               PrimesArrayOutput.data(), CurrentCRC);
+        if (BlockCRC) *BlockCRC = CurrentCRC;
+        if (status != primes_decoder_status_type::OK) PrimesArrayOutput.clear();
+        return status;
+    }
+
+    // prime number by its index in the list, index 0 is prime 2; the last decoded block is kept
+    primes_decoder_status_type prime(uint32_t index, uint32_t& P)
+    {
+        if (index >= count) return primes_decoder_status_type::out_of_range;
+
+        size_t k = index / length;
+        if (cached_block != k)
+        {
+            cached_block = no_block;
+            auto status = read_block(k, cache);
+            if (status != primes_decoder_status_type::OK) return status;
+            cached_block = k;
+        }
+
+        P = cache[index - block_first_index(k)];
+        return primes_decoder_status_type::OK;
+    }
+
+    // clears the output array, and fills it with primes from low to high inclusive, that are in the archive
+    primes_decoder_status_type range(uint32_t low, uint32_t high, std::vector<uint32_t>& PrimesArrayOutput)
+    {
+        PrimesArrayOutput.clear();
+        if (!is_open()) return primes_decoder_status_type::wrong_format;
+
+        // the last block that starts at or below low
+        size_t k = 0;
+        for (size_t lo=0, hi=block_count(); lo<hi; )
+        {
+            size_t mid = (lo + hi) / 2;
+            if (blocks[mid].first_prime <= low)
+            {
+                k = mid;
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        std::vector<uint32_t> part;
+        for (; k<block_count() && blocks[k].first_prime <= high; k++)
+        {
+            auto status = read_block(k, part);
+            if (status != primes_decoder_status_type::OK) return status;
+            for (auto P : part) if (P >= low && P <= high) PrimesArrayOutput.push_back(P);
+        }
+
+        return primes_decoder_status_type::OK;
+    }
+
+private:
+    struct block_entry_type
+    {
+        uint64_t offset = 0;        // from the start of archive
+        uint32_t first_prime = 0;
+    };
+
+    static constexpr size_t no_block = ~size_t(0);
+
+    sklib::bits_file_type* file = nullptr;
+    std::streampos base = 0;
+    uint32_t length = 0;
+    uint32_t count = 0;
+    uint32_t crc = 0;
+    std::vector<block_entry_type> blocks;   // one more entry at the end, for the end of archive
+
+    std::vector<uint32_t> cache;
+    size_t cached_block = no_block;
+
+    static bool read_octets(std::fstream& fs, std::streampos where, uint8_t* data, size_t N)
+    {
+        fs.clear();
+        fs.seekg(where);
+        fs.read(reinterpret_cast<char*>(data), std::streamsize(N));
+        return (fs.gcount() == std::streamsize(N));
+    }
+};
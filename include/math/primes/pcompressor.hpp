@@ -49,7 +49,359 @@ namespace primes_compressor
 enum class primes_decoder_status_type
 {
     OK = 0,
-    broken_archive, missing_CRC, CRC_mismatch, internal_bitstream_error
+    broken_archive, missing_CRC, CRC_mismatch, internal_bitstream_error, wrong_format, out_of_range
+};
+
+enum class primes_encoder_status_type
+{
+    OK = 0,
+    not_consecutive, gap_too_large
+};
+
+namespace priv
+{
+    // the timer is checked once per this many records
+    inline constexpr uint32_t primes_compressor_strobe_records = 1 << 12;
+
+    // code of the distance between indices of consecutive prime candidates, from 1 to tier_cap
+    constexpr sklib::aux::bits_variable_pack_type<int> primes_compressor_delta_code(int delta)
+    {
+        using namespace sklib::primes_compressor;
+
+        if (delta <= tierA) return sklib::bits_pack<int>(delta - 1, cutA);
+        if (delta <= tierB) return sklib::bits_pack<int>((onesA.data << zoneA) | (delta - tierA - 1), cutB);
+        if (delta <= tierC) return sklib::bits_pack<int>((onesB.data << zoneB) | (delta - tierB - 1), cutC);
+        return sklib::bits_pack<int>((onesC.data << zoneC) | (delta - tierC - 1), cut_cap);
+    }
+
+    inline void primes_compressor_write_delta(sklib::bits_stream_base_type& fPackedOutput, int delta)
+    {
+        fPackedOutput.write(primes_compressor_delta_code(delta));
+    }
+
+    // Checks the prime number P at position k of the sequence, that follows the number "previous" (ignored for k < 3).
+    // The sequence must start from 2, 3, 5, then ascend over prime candidates 6n+-1 (see enumeration.hpp); delta receives
+    // the distance between indices of P and previous, from 1 to tier_cap, or 0 for the first three numbers.
+    // Used by all encoders: other input can't be represented, and it would make the archive unreadable.
+    inline primes_encoder_status_type primes_compressor_check(size_t k, uint32_t P, uint32_t previous, uint32_t& delta)
+    {
+        constexpr uint32_t head[] = { 2, 3, 5 };
+
+        delta = 0;
+        if (k < std::size(head)) return (P == head[k] ? primes_encoder_status_type::OK : primes_encoder_status_type::not_consecutive);
+
+        if (P <= previous || (P % 6 != 1 && P % 6 != 5)) return primes_encoder_status_type::not_consecutive;
+
+        delta = sklib::prime_candidate_to_index<uint32_t>(P) - sklib::prime_candidate_to_index<uint32_t>(previous);
+        if (!delta) return primes_encoder_status_type::not_consecutive;
+        if (delta > uint32_t(sklib::primes_compressor::tier_cap)) return primes_encoder_status_type::gap_too_large;
+        return primes_encoder_status_type::OK;
+    }
+
+    // Fast decoding. The next 16 bits of the stream select an entry of the precomputed table, which holds all
+    // complete codes of tiers 0, A, B that fit into these bits (up to 4, every code is 4 to 12 bits long), and the number
+    // of bits they take. Codes of tier C and the end marker start with 12 ones, and they are decoded one by one.
+    // CRC of the 32-bit records is computed with 4 tables at once ("slicing by 4").
+
+    inline constexpr unsigned primes_compressor_peek_bits = 16;
+    inline constexpr unsigned primes_compressor_table_deltas = 4;
+    inline constexpr unsigned primes_compressor_count_bits = 3;
+    inline constexpr unsigned primes_compressor_used_bits = 5;
+    inline constexpr unsigned primes_compressor_delta_bits = 6;     // largest delta in the table is tierC
+
+    // bit length and the first delta of the codes in tiers 0, A, B
+    inline constexpr int primes_compressor_tiers[3][2] = { { sklib::primes_compressor::zone0, 0 },
+                                                           { sklib::primes_compressor::zoneA, sklib::primes_compressor::tierA },
+                                                           { sklib::primes_compressor::zoneB, sklib::primes_compressor::tierB } };
+
+    // entry: number of deltas, number of bits used, deltas from the first one
+    inline const uint32_t* primes_compressor_table()
+    {
+        static const std::vector<uint32_t> R = []()
+        {
+            constexpr unsigned W = primes_compressor_peek_bits;
+            std::vector<uint32_t> T(size_t(1) << W);
+
+            for (uint32_t v=0; v<T.size(); v++)
+            {
+                unsigned count = 0, used = 0;
+                uint32_t deltas = 0;
+
+                while (count < primes_compressor_table_deltas)
+                {
+                    unsigned pos = used;
+                    int delta = 0;
+                    for (auto& Z : primes_compressor_tiers)
+                    {
+                        if (pos + Z[0] > W) break;
+                        uint32_t field = (v >> (W - pos - Z[0])) & sklib::bits_data_mask<uint32_t>(Z[0]);
+                        pos += Z[0];
+                        if (field < sklib::bits_data_mask<uint32_t>(Z[0]))
+                        {
+                            delta = int(field) + Z[1] + 1;
+                            break;
+                        }
+                    }
+                    if (!delta) break;
+
+                    deltas |= uint32_t(delta) << (primes_compressor_delta_bits * count);
+                    count++;
+                    used = pos;
+                }
+
+                T[v] = count | (used << primes_compressor_count_bits) | (deltas << (primes_compressor_count_bits + primes_compressor_used_bits));
+            }
+            return T;
+        }();
+        return R.data();
+    }
+
+    // MSB-first reader of octets that come by chunks from source(begin, end), which returns false when there is no more data;
+    // reads zeros past the end of data
+    template<class F>
+    class primes_compressor_reader_type
+    {
+    public:
+        explicit primes_compressor_reader_type(F& chunk_source) : source(chunk_source) {}
+
+        // next n bits, n <= 32, stay in the stream
+        uint32_t peek(unsigned n)
+        {
+            if (available < n) refill();
+            return uint32_t(bit_register >> (width - n));
+        }
+
+        void skip(unsigned n)
+        {
+            bit_register <<= n;
+            available -= n;
+            consumed += n;
+        }
+
+        // true if the next n bits are all from the data
+        bool can_read(unsigned n = 1)
+        {
+            if (available < n) refill();
+            return (consumed + n <= delivered);
+        }
+
+        uint64_t bits_consumed() const { return consumed; }
+
+    private:
+        static constexpr unsigned width = sklib::bits_width_v<uint64_t>;
+
+        F& source;
+        const uint8_t* cursor = nullptr;
+        const uint8_t* cursor_end = nullptr;
+        bool exhausted = false;
+
+        uint64_t bit_register = 0;      // upper "available" bits are the next bits of the stream, the rest is zero
+        unsigned available = 0;
+        uint64_t consumed = 0;
+        uint64_t delivered = 0;
+
+        void refill()
+        {
+            while (available <= width - sklib::OCTET_BITS)
+            {
+                if (cursor == cursor_end && (exhausted || !source(cursor, cursor_end) || cursor == cursor_end))
+                {
+                    exhausted = true;
+                    available = width;
+                    return;
+                }
+
+                bit_register |= uint64_t(*cursor++) << (width - sklib::OCTET_BITS - available);
+                available += sklib::OCTET_BITS;
+                delivered += sklib::OCTET_BITS;
+            }
+        }
+    };
+
+    // reads one code of any length; returns 0 for the end marker
+    template<class R>
+    inline int primes_compressor_read_code(R& reader)
+    {
+        using namespace sklib::primes_compressor;
+
+        uint32_t v = reader.peek(cut_cap);
+        unsigned pos = 0;
+        for (auto& Z : primes_compressor_tiers)
+        {
+            uint32_t field = (v >> (cut_cap - pos - Z[0])) & sklib::bits_data_mask<uint32_t>(Z[0]);
+            pos += Z[0];
+            if (field < sklib::bits_data_mask<uint32_t>(Z[0]))
+            {
+                reader.skip(pos);
+                return int(field) + Z[1] + 1;
+            }
+        }
+
+        uint32_t field = v & sklib::bits_data_mask<uint32_t>(zoneC);
+        reader.skip(cut_cap);
+        return (field < sklib::bits_data_mask<uint32_t>(zoneC) ? int(field) + tierC + 1 : 0);
+    }
+
+    // decodes up to "limit" codes after the prime candidate with index Idx, calls emit(P) for every prime;
+    // stops at the end marker, and sets end_marker
+    template<class R, class F>
+    inline primes_decoder_status_type primes_compressor_decode_run(R& reader, uint32_t Idx, uint64_t limit, bool& end_marker, F&& emit)
+    {
+        constexpr unsigned data_shift = primes_compressor_count_bits + primes_compressor_used_bits;
+        const uint32_t* table = primes_compressor_table();
+        end_marker = false;
+
+        while (limit)
+        {
+            if (!reader.can_read()) return primes_decoder_status_type::broken_archive;
+
+            uint32_t E = table[reader.peek(primes_compressor_peek_bits)];
+            uint32_t count = E & sklib::bits_data_mask<uint32_t>(primes_compressor_count_bits);
+            if (count && count <= limit)
+            {
+                reader.skip((E >> primes_compressor_count_bits) & sklib::bits_data_mask<uint32_t>(primes_compressor_used_bits));
+                limit -= count;
+                for (E >>= data_shift; count--; E >>= primes_compressor_delta_bits)
+                {
+                    Idx += E & sklib::bits_data_mask<uint32_t>(primes_compressor_delta_bits);
+                    emit(sklib::prime_candidate<uint32_t>(Idx));
+                }
+                continue;
+            }
+
+            int delta = primes_compressor_read_code(reader);
+            if (!delta)
+            {
+                end_marker = true;
+                break;
+            }
+            Idx += delta;
+            limit--;
+            emit(sklib::prime_candidate<uint32_t>(Idx));
+        }
+
+        return primes_decoder_status_type::OK;
+    }
+
+    inline constexpr auto primes_compressor_crc_tables = []()
+    {
+        constexpr unsigned N = sklib::OCTET_ADDRESS_SPAN;
+        const uint32_t* T0 = sklib::crc_32_iso::get_table();
+        sklib::aux::encapsulated_array_type<uint32_t, 4 * N> R = { 0 };
+        for (unsigned i=0; i<N; i++) R.data[i] = T0[i];
+        for (unsigned k=1; k<4; k++)
+        {
+            for (unsigned i=0; i<N; i++)
+            {
+                uint32_t prev = R.data[(k-1)*N + i];
+                R.data[k*N + i] = (prev >> sklib::OCTET_BITS) ^ T0[prev & sklib::OCTET_MASK];
+            }
+        }
+        return R;
+    }();
+
+    // same as crc_32_iso::update_integer_lsb<uint32_t>(), one record per step
+    class primes_compressor_crc_type
+    {
+    public:
+        void update(uint32_t P)
+        {
+            constexpr unsigned N = sklib::OCTET_ADDRESS_SPAN;
+            const uint32_t* T = primes_compressor_crc_tables.data;
+            uint32_t v = vcrc ^ P;
+            vcrc = T[3*N + (v & sklib::OCTET_MASK)] ^ T[2*N + ((v >> 8) & sklib::OCTET_MASK)]
+                 ^ T[N + ((v >> 16) & sklib::OCTET_MASK)] ^ T[v >> 24];
+        }
+
+        uint32_t get() const { return ~vcrc; }
+
+    private:
+        uint32_t vcrc = ~uint32_t(0);
+    };
+
+    // primes_decode() for the stream that has no pending bits: reads the file directly, in large chunks
+    inline primes_decoder_status_type primes_decode_fast(sklib::bits_file_type& fPackedInput,
+                                                         std::vector<uint32_t>& PrimesArrayOutput,
+                                                         uint32_t& CurrentCRC,
+                                                         void (*heartbeat)(void*, uint32_t),
+                                                         void* payload)
+    {
+        constexpr size_t chunk_length = 1 << 16;
+
+        auto& fs = fPackedInput.file_stream();
+        auto start = fs.tellg();
+
+        // every code is at least 4 bits long, so the rest of the file cannot hold more than 2 codes per octet
+        fs.seekg(0, std::ios_base::end);
+        auto length = fs.tellg() - start;
+        fs.seekg(start);
+        std::vector<uint8_t> chunk(chunk_length);
+
+        auto source = [&](const uint8_t*& begin, const uint8_t*& end)
+        {
+            if (!fs.good()) return false;
+            fs.read(reinterpret_cast<char*>(chunk.data()), std::streamsize(chunk.size()));
+            begin = chunk.data();
+            end = begin + fs.gcount();
+            return (fs.gcount() > 0);
+        };
+        primes_compressor_reader_type<decltype(source)> reader(source);
+
+        // on every return, leave the file after the last octet of the archive taken by the decoder,
+        // the same as the bit-by-bit decoder does
+        struct file_restore_type
+        {
+            std::fstream& fs;
+            std::streampos start;
+            std::streamoff length;
+            const decltype(reader)& input;
+
+            ~file_restore_type()
+            {
+                // broken archive may end in the middle of the code that is taken as whole
+                std::streamoff taken = std::streamoff((input.bits_consumed() + sklib::OCTET_BITS - 1) / sklib::OCTET_BITS);
+                fs.clear();
+                fs.seekg(start + std::min(taken, length));
+            }
+        } restore{ fs, start, length, reader };
+
+        primes_compressor_crc_type Checksum;
+        sklib::timer_stopwatch_type strobe(1000);
+
+        PrimesArrayOutput.clear();
+        if (length > 0) PrimesArrayOutput.reserve(size_t(length) * (sklib::OCTET_BITS / sklib::primes_compressor::zone0) + 3);
+        for (uint32_t P : { 2, 3, 5 })
+        {
+            PrimesArrayOutput.push_back(P);
+            Checksum.update(P);
+        }
+
+        uint32_t nrecords = 3;
+        auto emit = [&](uint32_t P)
+        {
+            PrimesArrayOutput.push_back(P);
+            Checksum.update(P);
+            if (heartbeat && !(++nrecords % primes_compressor_strobe_records) && strobe(true)) heartbeat(payload, nrecords);
+        };
+
+        bool end_marker = false;
+        auto status = primes_compressor_decode_run(reader, 0, ~uint64_t(0), end_marker, emit);
+        if (status != primes_decoder_status_type::OK) return status;
+
+        nrecords = uint32_t(PrimesArrayOutput.size());
+        CurrentCRC = Checksum.get();
+
+        constexpr unsigned crc_width = sklib::bits_width_v<uint32_t>;
+        if (!reader.can_read(crc_width)) return primes_decoder_status_type::missing_CRC;
+        uint32_t StoredCRC = reader.peek(crc_width);
+        reader.skip(crc_width);
+
+        if (CurrentCRC != StoredCRC) return primes_decoder_status_type::CRC_mismatch;
+
+        if (heartbeat) heartbeat(payload, nrecords);
+
+        return primes_decoder_status_type::OK;
+    }
 };
 
 // clears the output array, reads file, and fills the array
@@ -57,6 +409,7 @@ enum class primes_decoder_status_type
 // if not nullptr, with payload and the number of records
 // does NOT rewind input file
 // returned CRC reflects the actual content of PrimesArrayOutput
+// if the archive starts at octet boundary, it is decoded by table (see above), bit by bit otherwise
 inline primes_decoder_status_type primes_decode(sklib::bits_file_type& fPackedInput,
                                                 std::vector<uint32_t>& PrimesArrayOutput,
                                                 uint32_t& CurrentCRC,
@@ -65,6 +418,8 @@ inline primes_decoder_status_type primes_decode(sklib::bits_file_type& fPackedIn
 {
     using namespace sklib::primes_compressor;
 
+    if (!fPackedInput.read_has_residual_data()) return sklib::priv::primes_decode_fast(fPackedInput, PrimesArrayOutput, CurrentCRC, heartbeat, payload);
+
     sklib::crc_32_iso Checksum;
     sklib::timer_stopwatch_type strobe(1000);
 
@@ -141,6 +496,137 @@ inline primes_decoder_status_type primes_decode(sklib::bits_file_type& fPackedIn
     return primes_decoder_status_type::OK;
 }
 
+// Streaming encoder, writes the format that primes_decode() reads. Primes are given one by one, in ascending order,
+// starting from 2, 3, 5 (the same layout as primes_decode() output); finish() writes the end marker and the CRC.
+// push() rejects the number that can't follow the previous one, see primes_compressor_check(); the number is skipped.
+// The archive starts at octet boundary: pending bits of the stream are flushed first. The codes are collected
+// in a register, then in a buffer of octets that goes directly into the file stream.
+// The encoder must not be used after finish().
+//
+class primes_encoder_type
+{
+public:
+    explicit primes_encoder_type(sklib::bits_file_type& fPackedOutput)
+        : output(fPackedOutput)
+    {
+        output.write_flush();
+        buffer.reserve(buffer_length);
+    }
+
+    primes_encoder_status_type push(uint32_t P)
+    {
+        uint32_t delta = 0;
+        auto status = sklib::priv::primes_compressor_check(nrecords, P, last, delta);
+        if (status != primes_encoder_status_type::OK) return status;
+        if (delta) put(sklib::priv::primes_compressor_delta_code(int(delta)));
+
+        last = P;
+        nrecords++;
+        Checksum.update(P);
+        return primes_encoder_status_type::OK;
+    }
+
+    // the archive must have at least 2, 3, 5
+    primes_encoder_status_type finish(uint32_t& CurrentCRC)
+    {
+        if (nrecords < 3) return primes_encoder_status_type::not_consecutive;
+
+        CurrentCRC = Checksum.get();
+        put(sklib::primes_compressor::ones_cap);
+        put(sklib::bits_pack<sklib::bits_width_v<uint32_t>, uint32_t>(CurrentCRC));
+
+        // pad the last octet with zeros, same as write_flush()
+        while (register_bits % sklib::OCTET_BITS) put(sklib::bits_pack<1, int>(0));
+        flush();
+
+        output.write_flush();
+        return primes_encoder_status_type::OK;
+    }
+
+    uint32_t size() const { return nrecords; }
+
+private:
+    static constexpr size_t buffer_length = 1 << 16;
+
+    sklib::bits_file_type& output;
+    sklib::priv::primes_compressor_crc_type Checksum;
+    uint32_t nrecords = 0;
+    uint32_t last = 0;
+
+    uint64_t bit_register = 0;      // lower register_bits bits are not in the buffer yet
+    unsigned register_bits = 0;
+    std::vector<uint8_t> buffer;
+
+    template<class TT>
+    void put(const TT& code)
+    {
+        bit_register = (bit_register << code.bit_count) | (uint64_t(code.data) & sklib::bits_data_mask<uint64_t>(code.bit_count));
+        register_bits += code.bit_count;
+
+        while (register_bits >= sklib::OCTET_BITS)
+        {
+            register_bits -= sklib::OCTET_BITS;
+            buffer.push_back(uint8_t(bit_register >> register_bits));
+        }
+        if (buffer.size() >= buffer_length) flush();
+    }
+
+    void flush()
+    {
+        output.file_stream().write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size()));
+        buffer.clear();
+    }
+};
+
+// writes archive of the primes from the array, which must start from 2, 3, 5 (the same layout as primes_decode() output)
+// every 1 second and immediately before successful exit calls heartbeat
+// if not nullptr, with payload and the number of records
+// returned CRC is the one written into the archive
+inline primes_encoder_status_type primes_encode(sklib::bits_file_type& fPackedOutput,
+                                                const std::vector<uint32_t>& PrimesArrayInput,
+                                                uint32_t& CurrentCRC,
+                                                void (*heartbeat)(void*, uint32_t) = nullptr,
+                                                void* payload = nullptr)
+{
+    sklib::timer_stopwatch_type strobe(1000);
+    primes_encoder_type Encoder(fPackedOutput);
+
+    for (auto P : PrimesArrayInput)
+    {
+        auto status = Encoder.push(P);
+        if (status != primes_encoder_status_type::OK) return status;
+        if (heartbeat && !(Encoder.size() % sklib::priv::primes_compressor_strobe_records) && strobe(true)) heartbeat(payload, Encoder.size());
+    }
+
+    auto status = Encoder.finish(CurrentCRC);
+    if (heartbeat && status == primes_encoder_status_type::OK) heartbeat(payload, Encoder.size());
+    return status;
+}
+
+// same as above, for all primes from 2 to limit inclusive, taken directly from the segmented sieve (see sieve.hpp)
+inline primes_encoder_status_type primes_encode(sklib::bits_file_type& fPackedOutput,
+                                                uint32_t limit,
+                                                uint32_t& CurrentCRC,
+                                                void (*heartbeat)(void*, uint32_t) = nullptr,
+                                                void* payload = nullptr)
+{
+    sklib::timer_stopwatch_type strobe(1000);
+    primes_encoder_type Encoder(fPackedOutput);
+    auto status = primes_encoder_status_type::OK;
+
+    sklib::primes_sieve_enumerate(limit, [&](uint64_t P)
+    {
+        status = Encoder.push(uint32_t(P));
+        if (heartbeat && !(Encoder.size() % sklib::priv::primes_compressor_strobe_records) && strobe(true)) heartbeat(payload, Encoder.size());
+        return (status == primes_encoder_status_type::OK);
+    });
+    if (status != primes_encoder_status_type::OK) return status;
+
+    status = Encoder.finish(CurrentCRC);
+    if (heartbeat && status == primes_encoder_status_type::OK) heartbeat(payload, Encoder.size());
+    return status;
+}
+
 inline constexpr bool is_primes_decoder_status_good(primes_decoder_status_type code)
 { return (code == primes_decoder_status_type::OK); }
 
@@ -158,6 +644,10 @@ inline constexpr std::string primes_decoder_status_msg(primes_decoder_status_typ
         return "Warning: input/control CRC mismatch";
     case primes_decoder_status_type::internal_bitstream_error:
         return "Bit stream error: received bits outside mask range (this cannot happen)";
+    case primes_decoder_status_type::wrong_format:
+        return "File error - not a block-indexed primes archive";
+    case primes_decoder_status_type::out_of_range:
+        return "Requested index is outside of the archive";
     default:
         return "Undefined error";
     }
@@ -0,0 +1,319 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides prime counting function pi(x) by Meissel's method, and the n-th prime number
+// This is internal SKLib file and must NOT be included directly.
+
+// With a = pi(x^(1/3)), Meissel's formula is: pi(x) = phi(x, a) + a - 1 - P2(x, a), where phi(x, a) counts integers
+// from 1 to x not divisible by any of the first a primes, and P2 counts numbers up to x that are products of two
+// primes greater than p_a: P2(x, a) = sum of (pi(x/p) - pi(p) + 1) for x^(1/3) < p <= x^(1/2).
+// phi() is expanded by the recurrence phi(y, b) = phi(y, b-1) - phi(y/p_b, b-1), which stops early at:
+// - b = 6, phi(y, 6) is periodic with the period 2*3*5*7*11*13 = 30030 and is taken from the table;
+// - small y and b, from the cache table built once by the same recurrence;
+// - y < p_(b+1)^2, then phi(y, b) = pi(y) - b + 1, with pi(y) from the wheel-30 bit set (see wheel.hpp).
+// Values pi(x/p) above the bit set are found by the segmented sieve (see sieve.hpp) in one pass up to x^(2/3).
+// Both phi(x, a) and the sieve pass are split between threads. Reference: D. H. Lehmer, "On the exact number of
+// primes less than a given limit", Illinois J. Math. 3 (1959), 381-388.
+
+namespace priv
+{
+    // phi(y, b) for b = prime_count_wheel_primes is taken from the table of one period
+    inline constexpr unsigned prime_count_wheel_primes = 6;
+    inline constexpr uint32_t prime_count_wheel_period = 2 * 3 * 5 * 7 * 11 * 13;
+
+    // phi(y, b) is cached for y < prime_count_cache_y and b < prime_count_cache_b
+    inline constexpr uint32_t prime_count_cache_y = 1 << 16;
+    inline constexpr unsigned prime_count_cache_b = 100;
+
+    // the bit set of primes covers at least this many integers, and prime_count_table_factor square roots of x
+    inline constexpr uint64_t prime_count_table_min = 1 << 20;
+    inline constexpr uint64_t prime_count_table_factor = 4;
+
+    // nth_prime() counts primes at an estimate, and sieves forward when this close to the answer
+    inline constexpr uint64_t prime_count_nth_window = 1 << 16;
+
+    constexpr sklib::aux::encapsulated_array_type<uint8_t, wheel30_span> prime_count_generate_upto_mask()
+    {
+        sklib::aux::encapsulated_array_type<uint8_t, wheel30_span> R = { 0 };
+        for (unsigned r=0; r<wheel30_span; r++)
+        {
+            for (unsigned k=0; k<wheel30_bits; k++) if (wheel30_offset[k] <= r) R.data[r] |= uint8_t(1 << k);
+        }
+        return R;
+    }
+
+    // bits of wheel-30 octet that represent numbers 30n+1 ... 30n+r
+    inline constexpr sklib::aux::encapsulated_array_type<uint8_t, wheel30_span> prime_count_upto_mask = prime_count_generate_upto_mask();
+};
+
+// Prime counting with the tables kept between calls: the bit set of primes grows when needed,
+// and the phi() cache is built once. The object must not be used from several threads at once.
+//
+class prime_counter_type
+{
+public:
+    prime_counter_type() = default;
+
+    // number of primes from 2 to x inclusive; threads=0 means all available CPU cores
+    uint64_t count(uint64_t x, unsigned threads = 0)
+    {
+        using namespace sklib::priv;
+
+        if (x < 2) return 0;
+
+        prepare(x);
+        if (x <= table.limit()) return pi(x);
+
+        size_t a = size_t(pi(sklib::ucbrt(x)));
+        return phi_top(x, a, threads) + a - 1 - P2(x, a, threads);
+    }
+
+    // k-th prime number, starting from nth(1) = 2; nth(0) returns 0
+    uint64_t nth(uint64_t k, unsigned threads = 0)
+    {
+        using namespace sklib::priv;
+
+        constexpr uint64_t first[] = { 0, 2, 3, 5 };
+        if (k < std::size(first)) return first[k];
+
+        // estimate by M. Cipolla (1902), then corrected by the local density of primes
+        double lk = std::log(double(k));
+        double llk = std::log(lk);
+        uint64_t x = uint64_t(alt_max(5.0, double(k) * (lk + llk - 1 + (llk - 2) / lk)));
+        uint64_t c = count(x, threads);
+
+        while (c >= k || k - c > prime_count_nth_window)
+        {
+            double target = double(k) - double(prime_count_nth_window / 2);
+            double next = double(x) + std::log(double(x)) * (target - double(c));
+            x = uint64_t(alt_max(5.0, next));
+            c = count(x, threads);
+        }
+
+        // the bit set of primes covers square root of 4x, more than enough for the gap
+        primes_sieve_segment_type S(primes);
+        S.seek(primes_sieve_index_cap(x));
+
+        while (size_t N = S.next(~uint64_t(0)))
+        {
+            const uint8_t* flag = S.data();
+            for (size_t j=0; j<N; j++)
+            {
+                if (flag[j] && ++c == k) return S.candidate(j);
+            }
+        }
+
+        return 0;   // not reachable
+    }
+
+private:
+    primes_wheel30_type table;
+    std::vector<uint32_t> primes;       // 2, 3, 5, ... up to the limit of the table
+    std::vector<uint32_t> rank;         // primes other than 2, 3, 5 in octets before 8k
+    std::vector<uint16_t> wheel_phi;    // phi(r, 6) for r < 30030
+    std::vector<uint16_t> cache;        // phi(y, b) at [(b - 6) * cache_y + y]
+
+    void prepare(uint64_t x)
+    {
+        using namespace sklib::priv;
+
+        uint64_t limit = alt_max(prime_count_table_min, sklib::usqrt(x) * prime_count_table_factor);
+        if (table.limit() < limit)
+        {
+            table.sieve(limit);
+            table.decode(primes);
+
+            const uint8_t* F = table.data();
+            rank.assign(table.size() / 8 + 1, 0);
+            uint32_t N = 0;
+            for (size_t k=0; k<table.size(); k++)
+            {
+                if (!(k % 8)) rank[k / 8] = N;
+                N += bits_table_distance.data[F[k]];
+            }
+        }
+
+        if (!wheel_phi.empty()) return;
+
+        wheel_phi.assign(prime_count_wheel_period, 0);
+        uint16_t N = 0;
+        for (uint32_t r=1; r<prime_count_wheel_period; r++)
+        {
+            bool coprime = true;
+            for (unsigned k=0; k<prime_count_wheel_primes; k++) coprime = coprime && (r % primes[k]);
+            wheel_phi[r] = (N += coprime);
+        }
+
+        // row by row: phi(y, b) = phi(y, b-1) - phi(y/p_b, b-1)
+        constexpr size_t Y = prime_count_cache_y;
+        cache.resize(Y * (prime_count_cache_b - prime_count_wheel_primes));
+        for (uint32_t y=0; y<Y; y++) cache[y] = uint16_t(phi_wheel(y));
+        for (size_t b=prime_count_wheel_primes+1; b<prime_count_cache_b; b++)
+        {
+            uint16_t* row = cache.data() + (b - prime_count_wheel_primes) * Y;
+            const uint16_t* prev = row - Y;
+            uint32_t p = primes[b-1];
+            for (uint32_t y=0; y<Y; y++) row[y] = uint16_t(prev[y] - prev[y / p]);
+        }
+    }
+
+    // y must not exceed the limit of the table
+    uint64_t pi(uint64_t y) const
+    {
+        using namespace sklib::priv;
+
+        if (y < wheel30_offset[1]) return (y >= 2) + (y >= 3) + (y >= 5);
+
+        const uint8_t* F = table.data();
+        size_t n = size_t(y / wheel30_span);
+        uint64_t R = 3 + rank[n / 8];
+        for (size_t k=n/8*8; k<n; k++) R += bits_table_distance.data[F[k]];
+        return R + bits_table_distance.data[F[n] & prime_count_upto_mask.data[y % wheel30_span]];
+    }
+
+    uint64_t phi_wheel(uint64_t y) const
+    {
+        constexpr uint64_t period = sklib::priv::prime_count_wheel_period;
+        return y / period * wheel_phi[period - 1] + wheel_phi[y % period];
+    }
+
+    // numbers from 1 to y not divisible by primes[0] ... primes[b-1]
+    uint64_t phi(uint64_t y, size_t b) const
+    {
+        using namespace sklib::priv;
+
+        if (b == prime_count_wheel_primes) return phi_wheel(y);
+        if (b < prime_count_wheel_primes) return (b ? phi(y, b-1) - phi(y / primes[b-1], b-1) : y);
+        if (y < prime_count_cache_y && b < prime_count_cache_b) return cache[(b - prime_count_wheel_primes) * prime_count_cache_y + y];
+
+        uint64_t p = primes[b];
+        if (y < p) return (y ? 1 : 0);
+        if (y < p*p && y <= table.limit()) return pi(y) - b + 1;
+
+        return phi_wheel(y) - phi_terms(y, prime_count_wheel_primes, b, 1);
+    }
+
+    // sum of phi(y/p_i, i) for i = first, first+step, ... below b
+    uint64_t phi_terms(uint64_t y, size_t first, size_t b, size_t step) const
+    {
+        uint64_t R = 0;
+        for (size_t i=first; i<b; i+=step)
+        {
+            uint64_t z = y / primes[i];
+            if (z < primes[i])      // phi(z, i) = 1 from here on
+            {
+                R += (b - i + step - 1) / step;
+                break;
+            }
+            R += phi(z, i);
+        }
+        return R;
+    }
+
+    // phi(x, a) with the terms of the top level split between threads
+    uint64_t phi_top(uint64_t x, size_t a, unsigned threads) const
+    {
+        sklib::aux::parallel_split_type split(a, 1, 1, threads);
+        std::vector<uint64_t> sums(split.size(), 0);
+
+        split.run([&](unsigned part, size_t, size_t)
+        {
+            sums[part] = phi_terms(x, sklib::priv::prime_count_wheel_primes + part, a, split.size());
+        });
+
+        uint64_t R = phi_wheel(x);
+        for (auto S : sums) R -= S;
+        return R;
+    }
+
+    // sum of pi(x/p) - pi(p) + 1 for x^(1/3) < p <= x^(1/2), p = primes[a] and up
+    uint64_t P2(uint64_t x, size_t a, unsigned threads) const
+    {
+        using namespace sklib::priv;
+
+        uint64_t R = 0;
+        std::vector<uint64_t> caps;     // x/p above the table, as candidate index caps, ascending
+
+        for (size_t i=size_t(pi(sklib::usqrt(x))); i-- > a; )
+        {
+            uint64_t y = x / primes[i];
+            R -= i;
+            if (y <= table.limit()) R += pi(y);
+            else caps.push_back(primes_sieve_index_cap(y));
+        }
+
+        // pi(y) = pi(limit) + primes with candidate index from "start" to cap(y)
+        uint64_t start = primes_sieve_index_cap(table.limit());
+        if (caps.empty() || caps.back() == start) return R + caps.size() * pi(table.limit());
+
+        std::vector<uint32_t> base(primes.begin(), primes.begin() + size_t(pi(sklib::usqrt(x / primes[a]))));
+
+        size_t length = primes_sieve_segment_type::default_segment_length;
+        sklib::aux::parallel_split_type split(size_t(caps.back() - start), length, length * primes_sieve_parallel_min_segments, threads);
+
+        std::vector<uint64_t> totals(split.size(), 0);      // primes in the range of the part
+        std::vector<uint64_t> sums(split.size(), 0);        // sum of primes before every cap, counted from the part start
+        std::vector<uint64_t> queries(split.size(), 0);     // number of caps in the range of the part
+
+        split.run([&](unsigned part, size_t begin, size_t end)
+        {
+            uint64_t B = start + begin;
+            uint64_t E = start + end;
+            auto q = (part ? std::upper_bound(caps.begin(), caps.end(), B) : caps.begin());
+            auto q_end = std::upper_bound(caps.begin(), caps.end(), E);
+            queries[part] = uint64_t(q_end - q);
+
+            primes_sieve_segment_type S(base, length);
+            S.seek(B);
+
+            uint64_t N = 0, sum = 0;
+            while (size_t L = S.next(E))
+            {
+                const uint8_t* flag = S.data();
+                uint64_t first = S.first_index();
+                size_t k = 0;
+                for (; q != q_end && *q <= first + L; q++)
+                {
+                    for (size_t j=size_t(*q - first); k<j; k++) N += flag[k];
+                    sum += N;
+                }
+                for (; k<L; k++) N += flag[k];
+            }
+
+            totals[part] = N;
+            sums[part] = sum;
+        });
+
+        uint64_t before = pi(table.limit());
+        for (unsigned part=0; part<split.size(); part++)
+        {
+            R += queries[part] * before + sums[part];
+            before += totals[part];
+        }
+
+        return R;
+    }
+};
+
+// Number of primes from 2 to x inclusive (prime counting function), practical for x up to about 10^15.
+// threads=0 means all available CPU cores.
+//
+inline uint64_t prime_count(uint64_t x, unsigned threads = 0)
+{
+    return prime_counter_type().count(x, threads);
+}
+
+// The k-th prime number, starting from nth_prime(1) = 2; returns 0 for k = 0.
+// threads=0 means all available CPU cores.
+//
+inline uint64_t nth_prime(uint64_t k, unsigned threads = 0)
+{
+    return prime_counter_type().nth(k, threads);
+}
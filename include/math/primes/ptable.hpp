@@ -0,0 +1,276 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides read-only table of primes, memory-mapped from file and shared between processes
+// This is internal SKLib file and must NOT be included directly.
+
+// The table file is written once from the list of primes (for example, decoded by primes_decode()), then any number
+// of processes map it read-only: the pages are shared through the system file cache, and opening takes no decoding.
+// Every prime is kept by the distance between indices of consecutive prime candidates (see enumeration.hpp), one octet
+// per prime, and every step-th prime is also kept in full. All numbers are 32-bit, least significant octet first:
+//
+//   magic "SKP3", number of primes, sample step, the last prime, CRC of all primes (same as primes_decode())
+//   samples: primes with indices 0, step, 2*step, ...
+//   gaps: one octet per prime, 0 for 2, 3, 5, and the distance from the previous index for the others
+//
+// Prime by index takes one sample and up to step-1 gaps; search by value is binary search over the samples.
+// Mapping of the file is system-dependent and it is placed in separate CODE file, same as for comms.hpp.
+// In order to open the table, dedicate a single .cpp file for the implementation, and place the single line in it:
+//   #include <SKLib/source/ptable-code.hpp>
+
+namespace priv
+{
+    inline constexpr uint32_t primes_table_magic = 0x534B5033;
+    inline constexpr uint32_t primes_table_default_step = 1 << 6;
+    inline constexpr size_t primes_table_header_octets = 5 * sizeof(uint32_t);
+
+    inline uint32_t primes_table_load32(const uint8_t* data)
+    {
+        uint32_t R = 0;
+        for (unsigned k=sizeof(uint32_t); k--; ) R = (R << sklib::OCTET_BITS) | data[k];
+        return R;
+    }
+
+    inline void primes_table_store32(std::vector<uint8_t>& output, uint32_t v)
+    {
+        for (unsigned k=0; k<sizeof(uint32_t); k++, v >>= sklib::OCTET_BITS) output.push_back(uint8_t(v));
+    }
+
+    // system objects of the mapped file, defined in the CODE file
+    struct primes_table_mapping_type;
+};
+
+// Writes the table file of the primes from the array, which must start from 2, 3, 5 (the same layout as primes_decode()
+// output), from the current position in the file; the file shall contain nothing else. Every step-th prime is sampled.
+// The sequence is checked the same way as by primes_archive_encode(). The file is not written if the input is rejected.
+//
+inline primes_encoder_status_type primes_table_write(sklib::bits_file_type& fOutput,
+                                                     const std::vector<uint32_t>& Primes,
+                                                     uint32_t step = sklib::priv::primes_table_default_step)
+{
+    using namespace sklib::priv;
+
+    if (!step) step = primes_table_default_step;
+
+    uint32_t count = uint32_t(Primes.size());
+    std::vector<uint8_t> gaps(count, 0);
+    primes_compressor_crc_type Checksum;
+
+    for (uint32_t k=0; k<count; k++)
+    {
+        Checksum.update(Primes[k]);
+
+        uint32_t delta = 0;
+        auto status = primes_compressor_check(k, Primes[k], (k ? Primes[k-1] : 0), delta);
+        if (status != primes_encoder_status_type::OK) return status;
+        gaps[k] = uint8_t(delta);
+    }
+
+    std::vector<uint8_t> header;
+    primes_table_store32(header, primes_table_magic);
+    primes_table_store32(header, count);
+    primes_table_store32(header, step);
+    primes_table_store32(header, (count ? Primes.back() : 0));
+    primes_table_store32(header, Checksum.get());
+    for (uint32_t k=0; k<count; k+=step) primes_table_store32(header, Primes[k]);
+
+    fOutput.write_flush();
+    auto& fs = fOutput.file_stream();
+    fs.write(reinterpret_cast<const char*>(header.data()), std::streamsize(header.size()));
+    fs.write(reinterpret_cast<const char*>(gaps.data()), std::streamsize(gaps.size()));
+    fs.flush();
+
+    return primes_encoder_status_type::OK;
+}
+
+// Reader of the table file. open() maps the whole file read-only, and verifies the header and the file size;
+// the primes themselves are verified by verify(), which reads the whole table.
+// Constructors, destructor, open() and close() are defined in the CODE file (see above).
+//
+class primes_table_type
+{
+public:
+    primes_table_type();
+    explicit primes_table_type(const std::string& filename);
+    ~primes_table_type();
+
+    primes_table_type(const primes_table_type&) = delete;
+    primes_table_type& operator= (const primes_table_type&) = delete;
+
+    primes_decoder_status_type open(const std::string& filename);
+    void close();
+
+    bool is_open() const { return (image != nullptr); }
+
+    uint32_t size() const { return count; }                 // number of primes in the table
+    uint32_t sample_step() const { return step; }
+    uint32_t last_prime() const { return last; }
+    uint32_t CRC() const { return crc; }                    // same as CRC from primes_decode() for the same primes
+
+    // computes CRC of the table
+    primes_decoder_status_type verify(uint32_t& CurrentCRC) const
+    {
+        sklib::priv::primes_compressor_crc_type Checksum;
+        enumerate(0, last, [&Checksum](uint32_t P) { Checksum.update(P); });
+        CurrentCRC = Checksum.get();
+        return (CurrentCRC == crc ? primes_decoder_status_type::OK : primes_decoder_status_type::CRC_mismatch);
+    }
+
+    // prime number by its index in the list, index 0 is prime 2
+    primes_decoder_status_type prime(uint32_t index, uint32_t& P) const
+    {
+        if (index >= count) return primes_decoder_status_type::out_of_range;
+
+        uint32_t k = index / step * step;
+        P = sample(index / step);
+        while (k < index) P = next(P, gaps[++k]);
+        return primes_decoder_status_type::OK;
+    }
+
+    // error if n is above the last prime in the table
+    eratosphenes_status_type is_prime(uint32_t n) const
+    {
+        if (n > last) return eratosphenes_status_type::error;
+
+        uint32_t index = 0, P = 0;
+        return (seek(n, index, P) && P == n ? eratosphenes_status_type::prime : eratosphenes_status_type::composite);
+    }
+
+    // Calls emit(prime) for every prime in the table from low to high inclusive, in ascending order.
+    // If emit() returns bool, false stops the enumeration. Returns false if stopped by emit().
+    template<class F>
+    bool enumerate(uint32_t low, uint32_t high, F&& emit) const
+    {
+        auto call = [&emit](uint32_t P) -> bool
+        {
+            if constexpr (std::is_same_v<decltype(emit(P)), bool>)
+            {
+                return emit(P);
+            }
+            else
+            {
+                emit(P);
+                return true;
+            }
+        };
+
+        uint32_t index = 0, P = 0;
+        if (low > high || !seek(low, index, P)) return true;
+
+        while (P < 5)
+        {
+            if (P > high) return true;
+            if (!call(P)) return false;
+            if (++index >= count) return true;
+            P = next(P, gaps[index]);
+        }
+
+        uint32_t Idx = sklib::prime_candidate_to_index<uint32_t>(P);
+        while (true)
+        {
+            if (P > high) return true;
+            if (!call(P)) return false;
+            if (++index >= count) return true;
+            Idx += gaps[index];
+            P = sklib::prime_candidate<uint32_t>(Idx);
+        }
+    }
+
+    // clears the output array, and fills it with primes from low to high inclusive, that are in the table
+    primes_decoder_status_type range(uint32_t low, uint32_t high, std::vector<uint32_t>& PrimesArrayOutput) const
+    {
+        PrimesArrayOutput.clear();
+        if (!is_open()) return primes_decoder_status_type::wrong_format;
+
+        enumerate(low, high, [&PrimesArrayOutput](uint32_t P) { PrimesArrayOutput.push_back(P); });
+        return primes_decoder_status_type::OK;
+    }
+
+private:
+    std::unique_ptr<sklib::priv::primes_table_mapping_type> mapping;
+
+    const uint8_t* image = nullptr;
+    uint32_t count = 0;
+    uint32_t step = 0;
+    uint32_t last = 0;
+    uint32_t crc = 0;
+    const uint8_t* samples = nullptr;
+    const uint8_t* gaps = nullptr;
+
+    // takes the table from the mapped file
+    primes_decoder_status_type attach(const uint8_t* data, size_t length)
+    {
+        using namespace sklib::priv;
+
+        if (length < primes_table_header_octets) return primes_decoder_status_type::broken_archive;
+        if (primes_table_load32(data) != primes_table_magic) return primes_decoder_status_type::wrong_format;
+
+        uint32_t N = primes_table_load32(data + sizeof(uint32_t));
+        uint32_t S = primes_table_load32(data + 2*sizeof(uint32_t));
+        if (!S) return primes_decoder_status_type::wrong_format;
+
+        size_t sample_count = (size_t(N) + S - 1) / S;
+        if (length != primes_table_header_octets + sample_count * sizeof(uint32_t) + N) return primes_decoder_status_type::broken_archive;
+
+        image = data;
+        count = N;
+        step = S;
+        last = primes_table_load32(data + 3*sizeof(uint32_t));
+        crc = primes_table_load32(data + 4*sizeof(uint32_t));
+        samples = data + primes_table_header_octets;
+        gaps = samples + sample_count * sizeof(uint32_t);
+        return primes_decoder_status_type::OK;
+    }
+
+    void detach()
+    {
+        image = samples = gaps = nullptr;
+        count = step = last = crc = 0;
+    }
+
+    uint32_t sample(size_t k) const { return sklib::priv::primes_table_load32(samples + k * sizeof(uint32_t)); }
+
+    static uint32_t next(uint32_t P, uint8_t gap)
+    {
+        if (P < 5) return (P == 2 ? 3 : 5);
+        return sklib::prime_candidate<uint32_t>(sklib::prime_candidate_to_index<uint32_t>(P) + gap);
+    }
+
+    // the first prime at or above n, and its index; false if all primes are below n
+    bool seek(uint32_t n, uint32_t& index, uint32_t& P) const
+    {
+        if (!count) return false;
+
+        // the last sample at or below n, or the first one
+        size_t k = 0;
+        for (size_t lo=0, hi=(size_t(count) + step - 1) / step; lo<hi; )
+        {
+            size_t mid = (lo + hi) / 2;
+            if (sample(mid) <= n)
+            {
+                k = mid;
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        index = uint32_t(k * step);
+        P = sample(k);
+        while (P < n)
+        {
+            if (++index >= count) return false;
+            P = next(P, gaps[index]);
+        }
+        return true;
+    }
+};
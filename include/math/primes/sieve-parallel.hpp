@@ -0,0 +1,123 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides multi-threaded segmented Sieve of Eratosphenes (see sieve.hpp)
+// This is internal SKLib file and must NOT be included directly.
+
+// The prime candidate index space is split into consecutive ranges, one per thread, at segment boundaries.
+// Sieving primes (up to square root of the limit) are computed once and shared by all threads; every thread
+// has its own primes_sieve_segment_type that keeps its own progress offsets, so threads don't interact.
+// Results are either merged in ascending order, or only counted (prime counting function pi(x)).
+
+namespace priv
+{
+    // don't give a thread less than this number of segments
+    inline constexpr size_t primes_sieve_parallel_min_segments = 16;
+
+    template<class F>
+    void primes_sieve_parallel_run(uint64_t limit, unsigned threads, size_t segment_length, F&& worker)
+    {
+        if (!segment_length) segment_length = sklib::primes_sieve_segment_type::default_segment_length;
+
+        std::vector<uint32_t> base;
+        sklib::priv::primes_sieve_base(sklib::usqrt(limit), base, segment_length);
+
+        uint64_t cap = sklib::priv::primes_sieve_index_cap(limit);
+        sklib::aux::parallel_split_type split(size_t(cap), segment_length, segment_length * primes_sieve_parallel_min_segments, threads);
+
+        worker(split, base, segment_length);
+    }
+};
+
+// Returns the number of primes from 2 to limit inclusive (prime counting function).
+// threads=0 means all available CPU cores.
+//
+inline uint64_t primes_count_parallel(uint64_t limit, unsigned threads = 0,
+                                      size_t segment_length = primes_sieve_segment_type::default_segment_length)
+{
+    if (limit < 2) return 0;
+    if (limit < 3) return 1;
+
+    uint64_t R = 2;
+    sklib::priv::primes_sieve_parallel_run(limit, threads, segment_length,
+        [&R](const sklib::aux::parallel_split_type& split, const std::vector<uint32_t>& base, size_t length)
+    {
+        std::vector<uint64_t> counts(split.size(), 0);
+
+        split.run([&](unsigned part, size_t begin, size_t end)
+        {
+            primes_sieve_segment_type S(base, length);
+            S.seek(begin);
+
+            uint64_t N = 0;
+            while (size_t L = S.next(end))
+            {
+                const uint8_t* flag = S.data();
+                for (size_t k=0; k<L; k++) N += flag[k];
+            }
+            counts[part] = N;
+        });
+
+        for (auto N : counts) R += N;
+    });
+
+    return R;
+}
+
+// Clears the output array and fills it with all primes from 2 to limit inclusive, in ascending order.
+// The layout is the same as of primes_decode(): 2, 3, 5, 7, ... The limit is clamped to the maximum of T.
+// Every thread collects its primes separately, then the parts are moved into output (also in parallel).
+// threads=0 means all available CPU cores.
+//
+template<class T>
+SKLIB_TYPE_ENABLE_IF_NATIVE_UINT(void, T) primes_sieve_parallel(uint64_t limit, std::vector<T>& PrimesArrayOutput, unsigned threads = 0,
+                                                                size_t segment_length = primes_sieve_segment_type::default_segment_length)
+{
+    PrimesArrayOutput.clear();
+    limit = sklib::priv::alt_min<uint64_t>(limit, sklib::bits_mask_v<T>);
+
+    if (limit >= 2) PrimesArrayOutput.push_back(2);
+    if (limit >= 3) PrimesArrayOutput.push_back(3);
+    if (limit < 5) return;
+
+    sklib::priv::primes_sieve_parallel_run(limit, threads, segment_length,
+        [&PrimesArrayOutput, threads](const sklib::aux::parallel_split_type& split, const std::vector<uint32_t>& base, size_t length)
+    {
+        std::vector<std::vector<T>> parts(split.size());
+
+        split.run([&](unsigned part, size_t begin, size_t end)
+        {
+            primes_sieve_segment_type S(base, length);
+            S.seek(begin);
+
+            auto& out = parts[part];
+            while (size_t L = S.next(end))
+            {
+                const uint8_t* flag = S.data();
+                for (size_t k=0; k<L; k++) if (flag[k]) out.push_back(T(S.candidate(k)));
+            }
+        });
+
+        // ordered merge: every part has its known place in the output
+        std::vector<size_t> place(parts.size() + 1, PrimesArrayOutput.size());
+        for (size_t k=0; k<parts.size(); k++) place[k+1] = place[k] + parts[k].size();
+        PrimesArrayOutput.resize(place.back());
+
+        sklib::aux::parallel_split_type(parts.size(), 1, 1, threads).run([&](unsigned, size_t begin, size_t end)
+        {
+            for (size_t k=begin; k<end; k++)
+            {
+                T* out = PrimesArrayOutput.data() + place[k];
+                for (auto p : parts[k]) *out++ = p;
+                std::vector<T>().swap(parts[k]);
+            }
+        });
+    });
+}
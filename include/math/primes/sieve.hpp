@@ -0,0 +1,199 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides segmented Sieve of Eratosphenes over the prime candidate index space (see enumeration.hpp)
+// This is internal SKLib file and must NOT be included directly.
+
+// The sieve keeps one octet per prime candidate 6n+-1, so multiples of 2 and 3 are not stored at all.
+// For every sieving prime p>=5, its multiples among the candidates are p*m where m is candidate itself;
+// they form two arithmetic progressions in the index space (one per residue of m modulo 6), both with
+// step 2p. The index space is processed by consecutive segments that fit into CPU cache, and every
+// progression remembers where it stopped, so the cost of a segment is proportional to its length.
+
+namespace priv
+{
+    // segment lengths in prime candidates (one octet each)
+    inline constexpr size_t primes_sieve_L1_segment = 32 * 1024;
+    inline constexpr size_t primes_sieve_L2_segment = 256 * 1024;
+
+    // number of prime candidates that are less or equal to the limit
+    constexpr uint64_t primes_sieve_index_cap(uint64_t limit)
+    {
+        if (limit < 5) return 0;
+        auto rem = limit % 6;
+        return sklib::prime_candidate_to_index_ex<uint64_t>(limit) + ((rem == 1 || rem == 5) ? 1 : 0);
+    }
+
+    inline void primes_sieve_base(uint64_t limit, std::vector<uint32_t>& Primes, size_t segment_length);
+};
+
+// One segment of the sieve at a time, moving forward through the index space.
+// Sieving primes are given in the same layout as primes_decode() output: 2, 3, 5, 7, ... (2 and 3 are
+// not used), and must include all primes up to the square root of the highest candidate being sieved.
+// The list is not copied, and multiple instances may share it (every instance keeps its own offsets).
+//
+class primes_sieve_segment_type
+{
+public:
+    static constexpr size_t default_segment_length = sklib::priv::primes_sieve_L1_segment;
+
+    primes_sieve_segment_type(const std::vector<uint32_t>& sieving_primes, size_t segment_length = default_segment_length)
+        : primes(sieving_primes)
+        , length(segment_length ? segment_length : default_segment_length)
+        , flags(length)
+    {
+        seek(0);
+    }
+
+    // next segment starts at candidate index "start"
+    void seek(uint64_t start)
+    {
+        position = start;
+        first = start;
+        count = 0;
+        active = 0;
+        offsets.clear();
+
+        for (size_t k=2; k<primes.size(); k++)
+        {
+            uint64_t p = primes[k];
+            uint64_t m = p + ((p % 6 == 5) ? 2 : 4);    // next prime candidate after p
+            progress_type R;
+            R.step = 2*p;
+            R.square = sklib::prime_candidate_to_index<uint64_t>(p*p);
+            R.next[0] = forward(R.square, R.step);
+            R.next[1] = forward(sklib::prime_candidate_to_index<uint64_t>(p*m), R.step);
+            offsets.push_back(R);
+        }
+    }
+
+    // sieves the next segment, up to but not including candidate index "cap"
+    // returns number of candidates in the segment, 0 when the cap is reached
+    size_t next(uint64_t cap)
+    {
+        first = position;
+        count = (cap > position ? size_t(sklib::priv::alt_min<uint64_t>(cap - position, length)) : 0);
+        uint64_t end = position + count;
+
+        uint8_t* F = flags.data();
+        for (size_t k=0; k<count; k++) F[k] = 1;
+
+        // only primes with p^2 below the end of segment participate; offsets are ascending by p
+        while (active < offsets.size() && offsets[active].square < end) active++;
+
+        for (size_t k=0; k<active; k++)
+        {
+            auto& R = offsets[k];
+            size_t step = size_t(R.step);
+            for (auto& x : R.next)
+            {
+                if (x >= end) continue;
+                size_t j = size_t(x - position);
+                for (; j < count; j += step) F[j] = 0;
+                x = position + j;
+            }
+        }
+
+        position = end;
+        return count;
+    }
+
+    uint64_t first_index() const { return first; }
+    size_t size() const { return count; }
+
+    // k is position within the current segment, 0 to size()-1
+    bool is_prime(size_t k) const { return flags[k] != 0; }
+    uint64_t candidate(size_t k) const { return sklib::prime_candidate<uint64_t>(first + k); }
+
+    const uint8_t* data() const { return flags.data(); }
+
+private:
+    struct progress_type
+    {
+        uint64_t step;
+        uint64_t square;        // index of p^2, where the sieving by p starts
+        uint64_t next[2];       // next index to cross out, for both progressions
+    };
+
+    const std::vector<uint32_t>& primes;
+    const size_t length;
+    std::vector<uint8_t> flags;
+    std::vector<progress_type> offsets;
+
+    uint64_t position = 0;  // where the next segment starts
+    uint64_t first = 0;     // start of the current segment
+    size_t count = 0;       // length of the current segment
+    size_t active = 0;      // number of sieving primes that reached the current segment
+
+    uint64_t forward(uint64_t idx, uint64_t step) const
+    {
+        return (idx >= position ? idx : idx + (position - idx + step - 1) / step * step);
+    }
+};
+
+// Calls emit(prime) for every prime number from 2 to limit inclusive, in ascending order.
+// If emit() returns bool, false stops the enumeration. Returns false if stopped by emit().
+//
+template<class F>
+bool primes_sieve_enumerate(uint64_t limit, F&& emit, size_t segment_length = primes_sieve_segment_type::default_segment_length)
+{
+    auto call = [&emit](uint64_t p) -> bool
+    {
+        if constexpr (std::is_same_v<decltype(emit(p)), bool>)
+        {
+            return emit(p);
+        }
+        else
+        {
+            emit(p);
+            return true;
+        }
+    };
+
+    if (limit < 2) return true;
+    if (!call(2)) return false;
+    if (limit < 3) return true;
+    if (!call(3)) return false;
+
+    std::vector<uint32_t> base;
+    sklib::priv::primes_sieve_base(sklib::usqrt(limit), base, segment_length);
+
+    primes_sieve_segment_type S(base, segment_length);
+    uint64_t cap = sklib::priv::primes_sieve_index_cap(limit);
+
+    while (size_t N = S.next(cap))
+    {
+        const uint8_t* flag = S.data();
+        for (size_t k=0; k<N; k++)
+        {
+            if (flag[k] && !call(S.candidate(k))) return false;
+        }
+    }
+
+    return true;
+}
+
+// Clears the output array and fills it with all primes from 2 to limit inclusive.
+// The layout is the same as of primes_decode(): 2, 3, 5, 7, ...
+//
+inline void primes_sieve(uint32_t limit, std::vector<uint32_t>& PrimesArrayOutput,
+                         size_t segment_length = primes_sieve_segment_type::default_segment_length)
+{
+    sklib::priv::primes_sieve_base(limit, PrimesArrayOutput, segment_length);
+}
+
+namespace priv
+{
+    inline void primes_sieve_base(uint64_t limit, std::vector<uint32_t>& Primes, size_t segment_length)
+    {
+        Primes.clear();
+        sklib::primes_sieve_enumerate(limit, [&Primes](uint64_t p) { Primes.push_back(uint32_t(p)); }, segment_length);
+    }
+};
@@ -0,0 +1,231 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// Provides wheel-30 bit set representation of prime numbers, and the Sieve of Eratosphenes on it
+// This is internal SKLib file and must NOT be included directly.
+
+// Among every 30 consecutive integers, only 8 are not divisible by 2, 3, or 5: 30n + {1,7,11,13,17,19,23,29}.
+// One octet represents 30 integers, one bit per such number (LSB is 30n+1), which is 8/30 of a bit per integer,
+// compared to 1/3 octet per integer of the 6n+-1 index space used by prime_candidate(), see enumeration.hpp.
+// Multiples of p that are coprime to 30 form 8 progressions p*m, one per residue of m modulo 30; each one
+// lands on the same bit of every p-th octet. Multiples of 7, 11, 13 are removed before sieving by copying
+// the precomputed periodic pattern of 7*11*13 octets. Then the octets are sieved by cache-sized blocks.
+
+namespace priv
+{
+    inline constexpr unsigned wheel30_span = 30;
+    inline constexpr unsigned wheel30_bits = 8;
+    inline constexpr uint8_t wheel30_offset[wheel30_bits] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+    inline constexpr uint8_t wheel30_no_bit = 0xFF;
+
+    constexpr sklib::aux::encapsulated_array_type<uint8_t, wheel30_span> wheel30_generate_bit_table()
+    {
+        sklib::aux::encapsulated_array_type<uint8_t, wheel30_span> R = { 0 };
+        for (unsigned k=0; k<wheel30_span; k++) R.data[k] = wheel30_no_bit;
+        for (unsigned k=0; k<wheel30_bits; k++) R.data[wheel30_offset[k]] = uint8_t(k);
+        return R;
+    }
+
+    // bit number for the residue modulo 30, or wheel30_no_bit if the residue is not coprime to 30
+    inline constexpr sklib::aux::encapsulated_array_type<uint8_t, wheel30_span> wheel30_bit_of_residue = wheel30_generate_bit_table();
+
+    inline constexpr size_t wheel30_presieve_length = 7 * 11 * 13;
+
+    constexpr sklib::aux::encapsulated_array_type<uint8_t, wheel30_presieve_length> wheel30_generate_presieve_pattern()
+    {
+        sklib::aux::encapsulated_array_type<uint8_t, wheel30_presieve_length> R = { 0 };
+        for (size_t n=0; n<wheel30_presieve_length; n++)
+        {
+            for (unsigned k=0; k<wheel30_bits; k++)
+            {
+                size_t v = wheel30_span * n + wheel30_offset[k];
+                if (v % 7 && v % 11 && v % 13) R.data[n] |= uint8_t(1 << k);
+            }
+        }
+        return R;
+    }
+
+    // octet n of the bit set without multiples of 7, 11, 13 is pattern[n % (7*11*13)]
+    inline constexpr sklib::aux::encapsulated_array_type<uint8_t, wheel30_presieve_length> wheel30_presieve_pattern = wheel30_generate_presieve_pattern();
+
+    // in octet 0: 7, 11, 13 are primes but removed by presieve; 1 is not prime
+    inline constexpr uint8_t wheel30_presieve_restore = 0x0E;
+};
+
+// Position of the prime candidate with given 6n+-1 index in wheel-30 bit set.
+// Returns false if the candidate is divisible by 5 and therefore has no place in the bit set.
+//
+inline constexpr bool wheel30_from_candidate_index(uint64_t idx, uint64_t& octet, unsigned& bit)
+{
+    uint64_t value = sklib::prime_candidate<uint64_t>(idx);
+    octet = value / sklib::priv::wheel30_span;
+    bit = sklib::priv::wheel30_bit_of_residue.data[value % sklib::priv::wheel30_span];
+    return (bit != sklib::priv::wheel30_no_bit);
+}
+
+// The 6n+-1 index of the number in wheel-30 bit set. Octet 0, bit 0 (number 1) has no index.
+//
+inline constexpr uint64_t wheel30_to_candidate_index(uint64_t octet, unsigned bit)
+{
+    return sklib::prime_candidate_to_index<uint64_t>(sklib::priv::wheel30_span * octet + sklib::priv::wheel30_offset[bit]);
+}
+
+// Bit set of all primes up to the limit, wheel-30 representation.
+// Primes 2, 3, 5 are not stored, but they are reported by is_prime(), count(), enumerate().
+//
+class primes_wheel30_type
+{
+public:
+    static constexpr size_t default_block_length = sklib::priv::primes_sieve_L1_segment;
+
+    primes_wheel30_type() = default;
+    explicit primes_wheel30_type(uint64_t limit, size_t block_length = default_block_length) { sieve(limit, block_length); }
+
+    // replaces the content with all primes from 2 to limit inclusive
+    void sieve(uint64_t limit, size_t block_length = default_block_length)
+    {
+        using namespace sklib::priv;
+
+        if (!block_length) block_length = default_block_length;
+
+        top = limit;
+        flags.assign(size_t(limit / wheel30_span + 1), 0);
+
+        std::vector<uint32_t> base;
+        sklib::primes_sieve(uint32_t(sklib::usqrt(limit)), base, block_length);
+
+        // 8 progressions for every sieving prime 17 and up; they are in ascending order of p
+        std::vector<progress_type> progress;
+        for (auto p : base)
+        {
+            if (p < 17) continue;
+
+            uint64_t m = p;
+            unsigned mbit = wheel30_bit_of_residue.data[p % wheel30_span];
+            for (unsigned k=0; k<wheel30_bits; k++)
+            {
+                uint64_t v = uint64_t(p) * m;
+                progress.push_back({ p, uint8_t(~(1 << wheel30_bit_of_residue.data[v % wheel30_span])), v / wheel30_span });
+
+                mbit = (mbit + 1) % wheel30_bits;
+                m += (mbit ? wheel30_offset[mbit] - wheel30_offset[mbit-1] : wheel30_span + wheel30_offset[0] - wheel30_offset[wheel30_bits-1]);
+            }
+        }
+
+        size_t active = 0;
+        uint8_t* F = flags.data();
+
+        for (size_t start=0; start<flags.size(); start+=block_length)
+        {
+            size_t end = alt_min(flags.size(), start + block_length);
+
+            // presieve: copy the pattern starting at the corresponding phase
+            size_t phase = start % wheel30_presieve_length;
+            for (size_t k=start; k<end; )
+            {
+                size_t n = alt_min(end - k, wheel30_presieve_length - phase);
+                std::memcpy(F + k, wheel30_presieve_pattern.data + phase, n);
+                k += n;
+                phase = 0;
+            }
+            if (!start) F[0] = uint8_t((F[0] & ~1) | wheel30_presieve_restore);
+
+            // first progression of every prime starts at p^2, so p is active when it reached the block
+            while (active < progress.size() && progress[active].next < end) active += wheel30_bits;
+
+            for (size_t k=0; k<active; k++)
+            {
+                auto& R = progress[k];
+                size_t j = size_t(R.next);
+                for (; j < end; j += R.step) F[j] &= R.mask;
+                R.next = j;
+            }
+        }
+
+        // remove bits past the limit
+        for (unsigned k=0; k<wheel30_bits; k++)
+        {
+            if ((flags.size() - 1) * wheel30_span + wheel30_offset[k] > limit) flags.back() &= uint8_t(~(1 << k));
+        }
+    }
+
+    uint64_t limit() const { return top; }
+
+    bool is_prime(uint64_t n) const
+    {
+        if (n > top) return false;
+        if (n < sklib::priv::wheel30_offset[1]) return (n == 2 || n == 3 || n == 5);
+        unsigned bit = sklib::priv::wheel30_bit_of_residue.data[n % sklib::priv::wheel30_span];
+        return (bit != sklib::priv::wheel30_no_bit && ((flags[size_t(n / sklib::priv::wheel30_span)] >> bit) & 1));
+    }
+
+    // number of primes from 2 to limit inclusive
+    uint64_t count() const
+    {
+        uint64_t R = (top >= 2) + (top >= 3) + (top >= 5);
+        for (auto w : flags) R += sklib::priv::bits_table_distance.data[w];
+        return R;
+    }
+
+    // calls emit(prime) for every prime in ascending order; if emit() returns bool, false stops the enumeration
+    template<class F>
+    bool enumerate(F&& emit) const
+    {
+        auto call = [&emit](uint64_t p) -> bool
+        {
+            if constexpr (std::is_same_v<decltype(emit(p)), bool>)
+            {
+                return emit(p);
+            }
+            else
+            {
+                emit(p);
+                return true;
+            }
+        };
+
+        for (uint64_t p : { 2, 3, 5 }) if (p <= top && !call(p)) return false;
+
+        for (size_t n=0; n<flags.size(); n++)
+        {
+            for (unsigned w = flags[n]; w; w &= w - 1)
+            {
+                unsigned bit = sklib::bits_rank(uint8_t(w & (0u - w))) - 1;
+                if (!call(uint64_t(n) * sklib::priv::wheel30_span + sklib::priv::wheel30_offset[bit])) return false;
+            }
+        }
+
+        return true;
+    }
+
+    // clears the output array and fills it with all primes, the layout is the same as of primes_decode()
+    template<class T>
+    SKLIB_TYPE_ENABLE_IF_NATIVE_UINT(void, T) decode(std::vector<T>& PrimesArrayOutput) const
+    {
+        PrimesArrayOutput.clear();
+        PrimesArrayOutput.reserve(size_t(count()));
+        enumerate([&PrimesArrayOutput](uint64_t p) { PrimesArrayOutput.push_back(T(p)); });
+    }
+
+    // raw bit set, octet n covers integers from 30n to 30n+29
+    const uint8_t* data() const { return flags.data(); }
+    size_t size() const { return flags.size(); }
+
+private:
+    struct progress_type
+    {
+        uint32_t step;      // p octets, for 30p integers
+        uint8_t mask;       // all bits set except the one to clear
+        uint64_t next;      // next octet to sieve
+    };
+
+    uint64_t top = 0;
+    std::vector<uint8_t> flags;
+};
@@ -15,6 +15,7 @@
 #include "utility/macro-overloading.hpp"
 #include "utility/macro-misc.hpp"
 #include "utility/misc-helpers.hpp"
+#include "utility/parallel.hpp"
 
 #include "utility/testing-random-size-int.hpp"
 #include "utility/testing-specific.hpp"
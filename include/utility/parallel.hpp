@@ -0,0 +1,93 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+#ifndef SKLIB_INCLUDED_UTILITY_PARALLEL_HPP
+#define SKLIB_INCLUDED_UTILITY_PARALLEL_HPP
+
+#include "../configure.hpp"
+#ifndef SKLIB_TARGET_MCU
+
+#include <thread>
+#include <vector>
+
+#include "std-func.hpp"
+
+namespace sklib {
+
+// Provides simple fork-join helper to process consecutive ranges of data in multiple threads.
+// This is internal SKLib file and must NOT be included directly.
+
+namespace aux
+{
+    // number of threads to use when caller doesn't specify it (passes 0)
+    inline unsigned parallel_default_threads()
+    {
+        unsigned R = std::thread::hardware_concurrency();
+        return (R ? R : 1);
+    }
+
+    // Splits the span [0, count) into consecutive ranges, at most one range per thread.
+    // Every boundary between ranges is a multiple of "alignment", and only the last range
+    // may be shorter than "min_range" - so small tasks are not split at all.
+    // Ranges are numbered in ascending order, so per-range results can be merged deterministically.
+    class parallel_split_type
+    {
+    private:
+        size_t total = 0;
+        size_t step = 1;
+        unsigned parts = 0;
+
+    public:
+        parallel_split_type(size_t count, size_t alignment = 1, size_t min_range = 1, unsigned threads = 0)
+            : total(count)
+        {
+            if (!count) return;
+            if (!alignment) alignment = 1;
+            if (!threads) threads = parallel_default_threads();
+
+            size_t units = (count + alignment - 1) / alignment;
+            size_t min_units = sklib::priv::alt_max(size_t(1), (min_range + alignment - 1) / alignment);
+            size_t max_parts = sklib::priv::alt_max(size_t(1), units / min_units);
+            size_t n = sklib::priv::alt_min(size_t(threads), max_parts);
+
+            step = (units + n - 1) / n * alignment;
+            parts = unsigned((count + step - 1) / step);
+        }
+
+        unsigned size() const { return parts; }
+        size_t begin(unsigned k) const { return sklib::priv::alt_min(total, k * step); }
+        size_t end(unsigned k) const { return sklib::priv::alt_min(total, (k + 1) * step); }
+
+        // calls worker(k, begin(k), end(k)) for every range; range 0 runs in the calling thread
+        // returns when all ranges are done
+        template<class F>
+        void run(F&& worker) const
+        {
+            std::vector<std::thread> pool;
+            pool.reserve(parts);
+
+            for (unsigned k=1; k<parts; k++)
+            {
+                pool.emplace_back([&worker, this, k]() { worker(k, begin(k), end(k)); });
+            }
+
+            if (parts) worker(0u, begin(0), end(0));
+
+            for (auto& t : pool) t.join();
+        }
+    };
+
+}; // namespace aux
+
+}; // namespace sklib
+
+#endif // SKLIB_TARGET_MCU
+
+#endif // SKLIB_INCLUDED_UTILITY_PARALLEL_HPP
@@ -0,0 +1,139 @@
+// This file is part of SKLib: https://github.com/Secoh/SKLib
+// Copyright [2020-2025] Secoh
+//
+// Licensed under the GNU Lesser General Public License, Version 2.1 or later. See: https://www.gnu.org/licenses/
+// You may not use this file except in compliance with the License.
+// Software is distributed on "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// Special exception from GNU LGPL terms: you don't have to publish the compiled object binary file(s) for SKLib.
+// Modified source code and/or any derivative work requirements are still in effect. All such file(s) must be openly
+// published under the same terms as the original one(s), but you don't have to inherit the special exception above.
+
+// This file contains all the calls to external library(ies).
+// Any system/standard header specific to the functions used is also included exclusively here.
+// See file: "math/primes/ptable.hpp" for details how to use the split-header arrangement.
+
+#ifndef SKLIB_INCLUDED_PTABLE_IMPLEMENTATION
+#define SKLIB_INCLUDED_PTABLE_IMPLEMENTATION
+
+
+#ifndef SKLIB_INCLUDED_MATH_HPP
+#include "../include/math.hpp"
+#endif
+
+
+#if defined(_MSC_VER)
+#ifndef _WINDOWS_
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+#include <windows.h>
+#endif
+
+struct sklib::priv::primes_table_mapping_type
+{
+    HANDLE hfile = INVALID_HANDLE_VALUE;
+    HANDLE hmap = NULL;
+    const void* view = nullptr;
+};
+
+#elif defined(__GNUC__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct sklib::priv::primes_table_mapping_type
+{
+    void* view = MAP_FAILED;
+    size_t length = 0;
+};
+
+#endif
+
+
+sklib::primes_table_type::primes_table_type() {}
+
+sklib::primes_table_type::primes_table_type(const std::string& filename)
+{
+    open(filename);
+}
+
+sklib::primes_table_type::~primes_table_type()
+{
+    close();
+}
+
+sklib::primes_decoder_status_type sklib::primes_table_type::open(const std::string& filename)
+{
+    close();
+    if (!mapping) mapping = std::make_unique<sklib::priv::primes_table_mapping_type>();
+
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+
+#if defined(_MSC_VER)
+    mapping->hfile = ::CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mapping->hfile == INVALID_HANDLE_VALUE) return primes_decoder_status_type::broken_archive;
+
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(mapping->hfile, &file_size) || !file_size.QuadPart)
+    {
+        close();
+        return primes_decoder_status_type::broken_archive;
+    }
+
+    mapping->hmap = ::CreateFileMappingA(mapping->hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping->hmap) mapping->view = ::MapViewOfFile(mapping->hmap, FILE_MAP_READ, 0, 0, 0);
+    if (!mapping->view)
+    {
+        close();
+        return primes_decoder_status_type::broken_archive;
+    }
+
+    data = static_cast<const uint8_t*>(mapping->view);
+    length = size_t(file_size.QuadPart);
+
+#elif defined(__GNUC__)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return primes_decoder_status_type::broken_archive;
+
+    struct stat file_info;
+    if (::fstat(fd, &file_info) || file_info.st_size <= 0)
+    {
+        ::close(fd);
+        return primes_decoder_status_type::broken_archive;
+    }
+
+    // the mapping stays valid after the file is closed
+    mapping->length = size_t(file_info.st_size);
+    mapping->view = ::mmap(nullptr, mapping->length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping->view == MAP_FAILED) return primes_decoder_status_type::broken_archive;
+
+    data = static_cast<const uint8_t*>(mapping->view);
+    length = mapping->length;
+
+#endif
+
+    auto status = attach(data, length);
+    if (status != primes_decoder_status_type::OK) close();
+    return status;
+}
+
+void sklib::primes_table_type::close()
+{
+    detach();
+    if (!mapping) return;
+
+#if defined(_MSC_VER)
+    if (mapping->view) ::UnmapViewOfFile(mapping->view);
+    if (mapping->hmap) ::CloseHandle(mapping->hmap);
+    if (mapping->hfile != INVALID_HANDLE_VALUE) ::CloseHandle(mapping->hfile);
+    *mapping = sklib::priv::primes_table_mapping_type();
+
+#elif defined(__GNUC__)
+    if (mapping->view != MAP_FAILED) ::munmap(mapping->view, mapping->length);
+    *mapping = sklib::priv::primes_table_mapping_type();
+
+#endif
+}
+
+#endif // SKLIB_INCLUDED_PTABLE_IMPLEMENTATION